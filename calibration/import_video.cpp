@@ -0,0 +1,74 @@
+#include <fmt/format.h>
+
+#include <chrono>
+#include <fstream>
+#include <opencv2/opencv.hpp>
+#include <string>
+
+#include "tools/frame_log.hpp"
+#include "tools/logger.hpp"
+
+// 定义命令行参数
+const std::string keys =
+  "{help h usage ? |             | 输出命令行参数说明 }"
+  "{codec          | lz4         | raw, lz4或jpeg    }"
+  "{output-path p  |             | 输出的录像目录，为空时与输入同名 }"
+  "{@input-path    |             | avi和txt文件的路径，不含扩展名 }";
+
+// 将旧版Recorder录制的avi+txt转换为分段二进制录像，供auto_aim_test、auto_buff_test和split_video使用
+// txt每行为：相对录制开始的时间(s) w x y z，与avi逐帧对应
+int main(int argc, char * argv[])
+{
+  // 读取命令行参数
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help") || !cli.has("@input-path")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto input_path = cli.get<std::string>(0);
+  auto output_path = cli.get<std::string>("output-path");
+  if (output_path.empty()) output_path = input_path;
+  auto codec = cli.get<std::string>("codec");
+
+  auto video_path = fmt::format("{}.avi", input_path);
+  auto text_path = fmt::format("{}.txt", input_path);
+  cv::VideoCapture video(video_path);
+  std::ifstream text(text_path);
+  if (!video.isOpened() || !text.is_open()) {
+    tools::logger()->error("Failed to open {} or {}", video_path, text_path);
+    return 1;
+  }
+
+  // 离线转换不允许丢帧
+  tools::FrameLogOptions options;
+  options.codec = codec == "raw"    ? tools::frame_log::Codec::RAW
+                  : codec == "jpeg" ? tools::frame_log::Codec::JPEG
+                                    : tools::frame_log::Codec::LZ4;
+  options.overflow = tools::Overflow::BLOCK;
+
+  // 时间戳为steady_clock的零点加txt中的时间，与合成录像一致
+  auto t0 = std::chrono::steady_clock::time_point{};
+  auto frame_count = 0;
+  {
+    tools::FrameLogWriter writer(output_path, options);
+    cv::Mat img;
+    while (video.read(img)) {
+      double t, w, x, y, z;
+      if (!(text >> t >> w >> x >> y >> z)) {
+        tools::logger()->warn(
+          "{} ends at frame {}, remaining frames dropped", text_path, frame_count);
+        break;
+      }
+
+      auto timestamp = t0 + std::chrono::microseconds(int64_t(t * 1e6));
+
+      // 姿态先于图像写入，与Recorder一致
+      writer.write_imu({w, x, y, z}, timestamp);
+      writer.write_frame(img, timestamp);
+      frame_count++;
+    }
+  }
+
+  tools::logger()->info("{} frames written to {}", frame_count, output_path);
+  return 0;
+}
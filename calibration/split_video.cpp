@@ -1,24 +1,23 @@
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <chrono>
-#include <fstream>
-#include <iomanip>
-#include <sstream>
 #include <string>
 
-#include "tools/exiter.hpp"
-#include "tools/img_tools.hpp"
+#include "tools/frame_log.hpp"
 #include "tools/logger.hpp"
-#include "tools/math_tools.hpp"
 
 // 定义命令行参数
 const std::string keys =
-  "{help h usage ? |                        | 输出命令行参数说明 }"
-  "{start-index s  |                        | 视频起始帧下标    }"
-  "{end-index e    |                        | 视频结束帧下标    }"
-  "{output-path p  | records/Big/2024-05-14_11-6-26     | avi和txt文件的路径}"
-  "{@input-path    |                        | avi和txt文件的路径}";
-
+  "{help h usage ? |             | 输出命令行参数说明 }"
+  "{start-index s  | 0           | 视频起始帧下标    }"
+  "{end-index e    | 0           | 视频结束帧下标，0表示到结尾 }"
+  "{start-time     | -1          | 起始时间(s)，不小于0时代替start-index }"
+  "{end-time       | -1          | 结束时间(s)，不小于0时代替end-index }"
+  "{output-path p  | records/cut | 输出的录像目录    }"
+  "{@input-path    |             | 录像目录，旧版avi+txt先用import_video转换 }";
+
+// 按帧索引截取录像，记录原样拷贝，不解码、不重新编码
 int main(int argc, char * argv[])
 {
   // 读取命令行参数
@@ -30,60 +29,32 @@ int main(int argc, char * argv[])
   auto input_path = cli.get<std::string>(0);
   auto output_path = cli.get<std::string>("output-path");
   auto start_index = cli.get<int>("start-index");
-  std::cout << start_index << std::endl;
   auto end_index = cli.get<int>("end-index");
+  auto start_time = cli.get<double>("start-time");
+  auto end_time = cli.get<double>("end-time");
 
-  // 初始化绘图器和退出器
-  tools::Exiter exiter;
-
-  // 构造视频和文本文件路径
-  auto video_path = fmt::format("{}.avi", input_path);
-  auto text_path = fmt::format("{}.txt", input_path);
-  cv::VideoCapture video(video_path);
-  std::ifstream text(text_path);
-
-  // 设置视频起始帧
-  video.set(cv::CAP_PROP_POS_FRAMES, start_index);
-  for (int i = 0; i < start_index; i++) {
-    double t, w, x, y, z;
-    text >> t >> w >> x >> y >> z;
+  tools::FrameLogReader recording(input_path);
+  if (recording.size() == 0) {
+    tools::logger()->error("No frames in {}", input_path);
+    return 1;
   }
-  // 获取原始视频的参数
-  int frameWidth = video.get(cv::CAP_PROP_FRAME_WIDTH);
-  int frameHeight = video.get(cv::CAP_PROP_FRAME_HEIGHT);
-  double fps = video.get(cv::CAP_PROP_FPS);
-  int fourcc = static_cast<int>(video.get(cv::CAP_PROP_FOURCC));
-
-  // 创建输出文件
-  auto outvideo_path = fmt::format("{}.avi", output_path);
-  auto outtext_path = fmt::format("{}.txt", output_path);
-  cv::VideoWriter outvideo(outvideo_path, fourcc, fps, cv::Size(frameWidth, frameHeight));
-  std::ofstream outtext(outtext_path);
-
-  std::string line;
-  cv::Mat img;
-
-  // 循环处理视频帧
-  for (int frame_count = start_index; !exiter.exit(); frame_count++) {
-    if (end_index > 0 && frame_count > end_index) break;
-
-    video.read(img);
-    if (img.empty()) break;
-
-    outvideo.write(img);
-
-    getline(text, line);
-    outtext << line << std::endl;
-
-    cv::resize(img, img, cv::Size(img.size().width * 0.8, img.size().height * 0.8));
-    cv::imshow("result", img);
 
-    int key = cv::waitKey(1);
-    if (key == 'q') break;
+  // 时间相对第一帧
+  auto since_begin = [&](double t) {
+    return recording.timestamp(0) + std::chrono::microseconds(int64_t(t * 1e6));
+  };
+  std::size_t first = start_index;
+  std::size_t last = end_index > 0 ? end_index + 1 : recording.size();
+  if (start_time >= 0) first = recording.find(since_begin(start_time));
+  if (end_time >= 0) last = recording.find(since_begin(end_time));
+
+  if (!recording.cut(output_path, first, last)) {
+    tools::logger()->error("Failed to cut [{}, {}) of {}", first, last, input_path);
+    return 1;
   }
-  cv::destroyAllWindows();
-  text.close();  // 关闭文件
-  outtext.close();
+  tools::logger()->info(
+    "Cut [{}, {}) of {} into {}", first, std::min(last, recording.size()), input_path,
+    output_path);
 
   return 0;
 }
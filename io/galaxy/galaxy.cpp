@@ -2,6 +2,8 @@
 #include "opencv2/opencv.hpp"
 #include <iostream>
 #include <stdexcept>
+
+#include "tools/tracer.hpp"
 // #include <thread>
 
 namespace io {
@@ -415,6 +417,7 @@ void Galaxy::closeDevice() {
 
 void Galaxy::captureLoop() {
   std::cout << "Capture loop started" << std::endl;
+  TOOLS_TRACE_THREAD("galaxy.capture");
 
   while (capture_thread_running_) {
     if (!is_streaming_) {
@@ -446,7 +449,12 @@ void Galaxy::captureLoop() {
       // 在采集线程中进行Bayer转换（最耗时的部分）
       cv::Mat img;
       auto timestamp = std::chrono::steady_clock::now();
-      bool success = convertFrameToMat(frame_buffer, img);
+      TOOLS_TRACE_FRAME(timestamp);  // 与read()返回的时间戳相同，读取线程据此对应同一帧
+      bool success;
+      {
+        TOOLS_TRACE_SPAN("camera.convert");
+        success = convertFrameToMat(frame_buffer, img);
+      }
 
       // 归还帧缓存（尽快释放SDK缓冲区）
       GXQBuf(device_handle_, frame_buffer);
@@ -472,6 +480,7 @@ void Galaxy::read(cv::Mat &img,
   }
 
   // 从队列中取出已转换好的图像（阻塞等待）
+  TOOLS_TRACE_SPAN("camera.read");
   CameraData camera_data;
   frame_queue_.pop(camera_data);
 
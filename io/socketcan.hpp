@@ -110,7 +110,7 @@ private:
         try {
           read();
         } catch (const std::exception &e) {
-          tools::logger()->warn("SocketCAN::read() failed: {}", e.what());
+          TOOLS_LOG_WARN_LIMITED(1, "SocketCAN::read() failed: {}", e.what());
           ok_ = false;
           break;
         }
@@ -124,7 +124,7 @@ private:
     try {
       open();
     } catch (const std::exception &e) {
-      tools::logger()->warn("SocketCAN::open() failed: {}", e.what());
+      TOOLS_LOG_WARN_LIMITED(1, "SocketCAN::open() failed: {}", e.what());
     }
   }
 
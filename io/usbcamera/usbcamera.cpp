@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "tools/logger.hpp"
+#include "tools/tracer.hpp"
 #include "tools/yaml.hpp"
 
 using namespace std::chrono_literals;
@@ -74,7 +75,7 @@ cv::Mat USBCamera::read()
 {
   std::lock_guard<std::mutex> lock(cap_mutex_);
   if (!cap_.isOpened()) {
-    tools::logger()->warn("Failed to read {} USB camera", this->device_name);
+    TOOLS_LOG_WARN_LIMITED(1, "Failed to read {} USB camera", this->device_name);
     return cv::Mat();
   }
   cap_ >> img_;
@@ -83,6 +84,7 @@ cv::Mat USBCamera::read()
 
 void USBCamera::read(cv::Mat & img, std::chrono::steady_clock::time_point & timestamp)
 {
+  TOOLS_TRACE_SPAN("camera.read");
   CameraData data;
   queue_.pop(data);
 
@@ -96,7 +98,7 @@ void USBCamera::open()
   std::string true_device_name = "/dev/" + open_name_;
   cap_.open(true_device_name, cv::CAP_V4L);
   if (!cap_.isOpened()) {
-    tools::logger()->warn("Failed to open USB camera");
+    TOOLS_LOG_WARN_LIMITED(1, "Failed to open USB camera");
     return;
   }
   sharpness_ = cap_.get(cv::CAP_PROP_SHARPNESS);
@@ -128,12 +130,14 @@ void USBCamera::open()
     ok_ = true;
     std::this_thread::sleep_for(50ms);
     tools::logger()->info("[{} USB camera] capture thread started ", this->device_name);
+    TOOLS_TRACE_THREAD("usbcamera.capture");
     while (!quit_) {
       std::this_thread::sleep_for(1ms);
 
       cv::Mat img;
       bool success;
       {
+        TOOLS_TRACE_SPAN("camera.capture");
         std::lock_guard<std::mutex> lock(cap_mutex_);
         if (!cap_.isOpened()) {
           break;
@@ -142,7 +146,7 @@ void USBCamera::open()
       }
 
       if (!success) {
-        tools::logger()->warn("Failed to read frame, exiting capture thread");
+        TOOLS_LOG_WARN_LIMITED(1, "Failed to read frame, exiting capture thread");
         break;
       }
 
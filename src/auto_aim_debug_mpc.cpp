@@ -2,9 +2,9 @@
 
 #include <atomic>
 #include <chrono>
-#include <nlohmann/json.hpp>
 #include <opencv2/opencv.hpp>
 #include <thread>
+#include <vector>
 
 #include "io/camera.hpp"
 #include "io/gimbal/gimbal.hpp"
@@ -14,21 +14,25 @@
 #include "tasks/auto_aim/yolo.hpp"
 #include "tools/exiter.hpp"
 #include "tools/img_tools.hpp"
+#include "tools/latency_histogram.hpp"
 #include "tools/logger.hpp"
 #include "tools/math_tools.hpp"
-#include "tools/plotter.hpp"
+#include "tools/periodic_executor.hpp"
+#include "tools/telemetry.hpp"
 #include "tools/thread_safe_queue.hpp"
+#include "tools/tracer.hpp"
 
 using namespace std::chrono_literals;
 
 const std::string keys =
   "{help h usage ? |                        | 输出命令行参数说明}"
+  "{trace          | trace.json          | 按t键或退出时保存Chrome trace的路径 }"
   "{@config-path   | configs/sentry.yaml | 位置参数，yaml配置文件路径 }";
 
 int main(int argc, char * argv[])
 {
   tools::Exiter exiter;
-  tools::Plotter plotter;
+  tools::Telemetry telemetry;
 
   cv::CommandLineParser cli(argc, argv, keys);
   auto config_path = cli.get<std::string>(0);
@@ -36,6 +40,7 @@ int main(int argc, char * argv[])
     cli.printMessage();
     return 0;
   }
+  auto trace_path = cli.get<std::string>("trace");
 
   io::Gimbal gimbal(config_path);
   io::Camera camera(config_path);
@@ -45,77 +50,102 @@ int main(int argc, char * argv[])
   auto_aim::Tracker tracker(config_path, solver);
   auto_aim::Planner planner(config_path);
 
-  tools::ThreadSafeQueue<std::optional<auto_aim::Target>, true> target_queue(1);
+  tools::ThreadSafeQueue<std::optional<auto_aim::TargetSnapshot>, true> target_queue(1);
   target_queue.push(std::nullopt);
 
-  std::atomic<bool> quit = false;
+  // 通道在进入实时循环前注册，顺序与规划线程中的values一致
+  std::vector<tools::Telemetry::Channel> channels;
+  for (const auto * name :
+       {"gimbal_yaw", "gimbal_yaw_vel", "gimbal_pitch", "gimbal_pitch_vel", "target_yaw",
+        "target_pitch", "plan_yaw", "plan_yaw_vel", "plan_yaw_acc", "plan_pitch", "plan_pitch_vel",
+        "plan_pitch_acc", "yaw_iter", "yaw_solve_ms", "pitch_iter", "pitch_solve_ms",
+        "plan_period_us", "plan_jitter_us", "plan_overruns", "fire", "fired", "w"})
+    channels.push_back(telemetry.channel(name));
+  auto target_z = telemetry.channel("target_z");
+  auto target_vz = telemetry.channel("target_vz");
+
+  // 各阶段相对相机帧时间戳的延迟，glass_to_command为指令发出时所依据的帧已过去的时间
+  tools::LatencyMonitor latency(1s, &telemetry);
+  auto & glass_to_detect = latency.histogram("glass_to_detect");
+  auto & glass_to_track = latency.histogram("glass_to_track");
+  auto & glass_to_command = latency.histogram("glass_to_command");
+
+  // 以绝对截止时间每4ms规划一次，周期不随求解耗时漂移
+  tools::PeriodicExecutor executor(4ms);
   auto plan_thread = std::thread([&]() {
-    auto t0 = std::chrono::steady_clock::now();
+    TOOLS_TRACE_THREAD("plan");
     uint16_t last_bullet_count = 0;
 
-    while (!quit) {
+    executor.run([&] {
       auto target = target_queue.front();
+      TOOLS_TRACE_FRAME(target ? target->t : std::chrono::steady_clock::time_point{});
       auto gs = gimbal.state();
       auto plan = planner.plan(target, gs.bullet_speed);
 
-      gimbal.send(
-        plan.control, plan.fire, plan.yaw, plan.yaw_vel, plan.yaw_acc, plan.pitch, plan.pitch_vel,
-        plan.pitch_acc);
+      {
+        TOOLS_TRACE_SPAN("gimbal.send");
+        gimbal.send(
+          plan.control, plan.fire, plan.yaw, plan.yaw_vel, plan.yaw_acc, plan.pitch,
+          plan.pitch_vel, plan.pitch_acc);
+      }
+      if (plan.control) glass_to_command.record(std::chrono::steady_clock::now() - plan.frame_time);
 
       auto fired = gs.bullet_count > last_bullet_count;
       last_bullet_count = gs.bullet_count;
 
-      nlohmann::json data;
-      data["t"] = tools::delta_time(std::chrono::steady_clock::now(), t0);
-
-      data["gimbal_yaw"] = gs.yaw;
-      data["gimbal_yaw_vel"] = gs.yaw_vel;
-      data["gimbal_pitch"] = gs.pitch;
-      data["gimbal_pitch_vel"] = gs.pitch_vel;
-
-      data["target_yaw"] = plan.target_yaw;
-      data["target_pitch"] = plan.target_pitch;
-
-      data["plan_yaw"] = plan.yaw;
-      data["plan_yaw_vel"] = plan.yaw_vel;
-      data["plan_yaw_acc"] = plan.yaw_acc;
-
-      data["plan_pitch"] = plan.pitch;
-      data["plan_pitch_vel"] = plan.pitch_vel;
-      data["plan_pitch_acc"] = plan.pitch_acc;
-
-      data["fire"] = plan.fire ? 1 : 0;
-      data["fired"] = fired ? 1 : 0;
+      // 同一周期的数值使用同一时间戳，解码时合并为一个对象
+      auto t = std::chrono::steady_clock::now();
+      double values[] = {
+        gs.yaw,
+        gs.yaw_vel,
+        gs.pitch,
+        gs.pitch_vel,
+        plan.target_yaw,
+        plan.target_pitch,
+        plan.yaw,
+        plan.yaw_vel,
+        plan.yaw_acc,
+        plan.pitch,
+        plan.pitch_vel,
+        plan.pitch_acc,
+        double(planner.yaw_stats.iter),
+        planner.yaw_stats.time_ms,
+        double(planner.pitch_stats.iter),
+        planner.pitch_stats.time_ms,
+        executor.last_period_us(),
+        executor.last_jitter_us(),
+        double(executor.overruns()),
+        plan.fire ? 1.0 : 0.0,
+        fired ? 1.0 : 0.0,
+        target.has_value() ? target->x[7] : 0.0,
+      };
+      for (std::size_t i = 0; i < std::size(values); i++)
+        telemetry.record(channels[i], values[i], t);
 
       if (target.has_value()) {
-        data["target_z"] = target->ekf_x()[4];   //z
-        data["target_vz"] = target->ekf_x()[5];  //vz
+        telemetry.record(target_z, target->x[4], t);
+        telemetry.record(target_vz, target->x[5], t);
       }
-
-      if (target.has_value()) {
-        data["w"] = target->ekf_x()[7];
-      } else {
-        data["w"] = 0.0;
-      }
-
-      plotter.plot(data);
-
-      std::this_thread::sleep_for(4ms);
-    }
+    });
   });
 
   cv::Mat img;
   std::chrono::steady_clock::time_point t;
 
+  TOOLS_TRACE_THREAD("main");
+
   while (!exiter.exit()) {
     camera.read(img, t);
+    TOOLS_TRACE_FRAME(t);
     auto q = gimbal.q(t);
 
     solver.set_R_gimbal2world(q);
-    auto armors = yolo.detect(img);
-    auto targets = tracker.track(armors, t);
+    auto armors = TOOLS_TRACE_CALL("yolo.detect", yolo.detect(img));
+    glass_to_detect.record(std::chrono::steady_clock::now() - t);
+    auto targets = TOOLS_TRACE_CALL("tracker.track", tracker.track(armors, t));
+    glass_to_track.record(std::chrono::steady_clock::now() - t);
     if (!targets.empty())
-      target_queue.push(targets.front());
+      target_queue.push(targets.front().snapshot());
     else
       target_queue.push(std::nullopt);
 
@@ -140,11 +170,14 @@ int main(int argc, char * argv[])
     cv::imshow("reprojection", img);
     auto key = cv::waitKey(1);
     if (key == 'q') break;
+    if (key == 't') tools::trace::save(trace_path);
   }
 
-  quit = true;
+  executor.stop();
   if (plan_thread.joinable()) plan_thread.join();
   gimbal.send(false, false, 0, 0, 0, 0, 0, 0);
+  tools::logger()->info("[Plan] {}", executor.summary());
+  tools::trace::save(trace_path);
 
   return 0;
 }
\ No newline at end of file
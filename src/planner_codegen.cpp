@@ -0,0 +1,116 @@
+#include <fmt/format.h>
+
+#include <fstream>
+#include <map>
+#include <opencv2/opencv.hpp>
+#include <sstream>
+
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tasks/auto_aim/planner/static_solver.hpp"
+#include "tasks/auto_aim/planner/tinympc/tiny_api.hpp"
+#include "tools/logger.hpp"
+#include "tools/yaml.hpp"
+
+// 为每个机器人配置的yaw/pitch求解器预先计算TinyMPC缓存，生成static_solver_data.hpp
+// 生成的数据编译进auto_aim，Planner在配置哈希匹配时直接使用，跳过启动时的Riccati迭代
+const std::string keys =
+  "{help h usage ? |                                                       | 输出命令行参数说明}"
+  "{output o       | tasks/auto_aim/planner/static_solver_data.hpp         | 生成的头文件路径  }"
+  "{@config-paths  | configs/standard3.yaml,configs/standard4.yaml,configs/demo.yaml | "
+  "逗号分隔的yaml配置文件路径}";
+
+using auto_aim::DT;
+using auto_aim::HORIZON;
+
+auto_aim::StaticSolverData generate(
+  double max_acc, const std::vector<double> & Q, const std::vector<double> & R, double rho)
+{
+  Eigen::MatrixXd A{{1, DT}, {0, 1}};
+  Eigen::MatrixXd B{{0}, {DT}};
+  Eigen::MatrixXd f{{0}, {0}};
+  Eigen::VectorXd Q_dig = Eigen::Map<const Eigen::VectorXd>(Q.data(), 2);
+  Eigen::VectorXd R_dig = Eigen::Map<const Eigen::VectorXd>(R.data(), 1);
+
+  TinySolver * solver;
+  tiny_setup(&solver, A, B, f, Q_dig.asDiagonal(), R_dig.asDiagonal(), rho, 2, 1, HORIZON, 0);
+  const auto & cache = *solver->cache;
+
+  auto_aim::StaticSolverData data;
+  data.hash = auto_aim::solver_hash(DT, HORIZON, max_acc, Q, R, rho);
+  data.max_acc = max_acc;
+  std::copy(Q.begin(), Q.begin() + 2, data.Q);
+  std::copy(R.begin(), R.begin() + 1, data.R);
+  data.rho = cache.rho;
+
+  // 与tinympc/codegen.cpp中的print_matrix一致，按行优先展开
+  auto copy = [](const Eigen::MatrixXd & m, double * out) {
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+      out, m.rows(), m.cols()) = m;
+  };
+  copy(cache.Kinf, data.Kinf);
+  copy(cache.Pinf, data.Pinf);
+  copy(cache.Quu_inv, data.Quu_inv);
+  copy(cache.AmBKt, data.AmBKt);
+  copy(cache.APf, data.APf);
+  copy(cache.BPf, data.BPf);
+  return data;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto output_path = cli.get<std::string>("output");
+  auto config_paths = cli.get<std::string>(0);
+
+  // 相同参数的求解器只生成一份
+  std::map<uint64_t, std::pair<auto_aim::StaticSolverData, std::string>> solvers;
+
+  std::stringstream ss(config_paths);
+  std::string config_path;
+  while (std::getline(ss, config_path, ',')) {
+    auto yaml = tools::load(config_path);
+    auto rho = tools::read<double>(yaml, "mpc_rho");  // 与Planner::setup_static_solvers一致
+
+    for (const std::string axis : {"yaw", "pitch"}) {
+      auto max_acc = tools::read<double>(yaml, "max_" + axis + "_acc");
+      auto Q = tools::read<std::vector<double>>(yaml, "Q_" + axis);
+      auto R = tools::read<std::vector<double>>(yaml, "R_" + axis);
+      if (Q.size() != 2 || R.size() != 1) {
+        tools::logger()->error("{}: Q_{} or R_{} has wrong size!", config_path, axis, axis);
+        return 1;
+      }
+
+      auto data = generate(max_acc, Q, R, rho);
+      auto name = fmt::format("{} {}", config_path, axis);
+      auto [it, inserted] = solvers.try_emplace(data.hash, data, name);
+      if (!inserted) it->second.second += ", " + name;
+      tools::logger()->info("{}: hash 0x{:016x}", name, data.hash);
+    }
+  }
+
+  if (solvers.empty()) {
+    tools::logger()->error("No config given!");
+    return 1;
+  }
+
+  std::ofstream file(output_path);
+  file << "// 由src/planner_codegen.cpp生成，请勿手动修改\n"
+       << "#ifndef AUTO_AIM__STATIC_SOLVER_DATA_HPP\n"
+       << "#define AUTO_AIM__STATIC_SOLVER_DATA_HPP\n\n"
+       << "#include \"static_solver.hpp\"\n\n"
+       << "namespace auto_aim::generated\n{\n"
+       << "// hash, max_acc, Q, R, rho, Kinf, Pinf, Quu_inv, AmBKt, APf, BPf\n"
+       << "constexpr StaticSolverData STATIC_SOLVERS[] = {\n";
+  for (const auto & [hash, solver] : solvers)
+    file << auto_aim::to_source(solver.first, solver.second);
+  file << "};\n\n"
+       << "}  // namespace auto_aim::generated\n\n"
+       << "#endif  // AUTO_AIM__STATIC_SOLVER_DATA_HPP\n";
+
+  tools::logger()->info("{} solvers written to {}", solvers.size(), output_path);
+  return 0;
+}
@@ -11,6 +11,7 @@
 #include "io/ros2/ros2.hpp"
 #include "io/usbcamera/usbcamera.hpp"
 #include "tasks/auto_aim/aimer.hpp"
+#include "tasks/auto_aim/command_streamer.hpp"
 #include "tasks/auto_aim/shooter.hpp"
 #include "tasks/auto_aim/solver.hpp"
 #include "tasks/auto_aim/tracker.hpp"
@@ -18,10 +19,12 @@
 #include "tasks/omniperception/decider.hpp"
 #include "tools/exiter.hpp"
 #include "tools/img_tools.hpp"
+#include "tools/latency_histogram.hpp"
 #include "tools/logger.hpp"
 #include "tools/math_tools.hpp"
 #include "tools/plotter.hpp"
 #include "tools/recorder.hpp"
+#include "tools/telemetry.hpp"
 
 using namespace std::chrono;
 
@@ -34,6 +37,7 @@ int main(int argc, char * argv[])
   tools::Exiter exiter;
   tools::Plotter plotter;
   tools::Recorder recorder;
+  tools::Telemetry telemetry;
 
   cv::CommandLineParser cli(argc, argv, keys);
   if (cli.has("help")) {
@@ -57,6 +61,21 @@ int main(int argc, char * argv[])
 
   omniperception::Decider decider(config_path);
 
+  // 各阶段相对相机帧时间戳的延迟，glass_to_command为指令发出时所依据的帧已过去的时间
+  tools::LatencyMonitor latency(1s, &telemetry);
+  auto & glass_to_detect = latency.histogram("glass_to_detect");
+  auto & glass_to_track = latency.histogram("glass_to_track");
+  auto & glass_to_aim = latency.histogram("glass_to_aim");
+  auto & glass_to_command = latency.histogram("glass_to_command");
+
+  // 云台设定值由发送线程以stream_rate更新，与相机帧率无关
+  auto_aim::CommandStreamer streamer(config_path, [&](const auto_aim::StreamCommand & c) {
+    cboard.send(io::Command{c.control, c.shoot, c.yaw, c.pitch});
+    // 第一次update之前frame_time为零点，不控制时的指令不依据任何帧，均不计入
+    if (c.control && c.frame_time != steady_clock::time_point{})
+      glass_to_command.record(steady_clock::now() - c.frame_time);
+  });
+
   cv::Mat img;
 
   std::chrono::steady_clock::time_point timestamp;
@@ -73,6 +92,7 @@ int main(int argc, char * argv[])
     Eigen::Vector3d gimbal_pos = tools::eulers(solver.R_gimbal2world(), 2, 1, 0);
 
     auto armors = yolo.detect(img);
+    glass_to_detect.record(steady_clock::now() - timestamp);
 
     decider.get_invincible_armor(ros2.subscribe_enemy_status());
 
@@ -83,6 +103,7 @@ int main(int argc, char * argv[])
     decider.set_priority(armors);
 
     auto targets = tracker.track(armors, timestamp);
+    glass_to_track.record(steady_clock::now() - timestamp);
 
     io::Command command{false, false, 0, 0};
 
@@ -92,10 +113,17 @@ int main(int argc, char * argv[])
     else
       command = aimer.aim(targets, timestamp, cboard.bullet_speed, cboard.shoot_mode);
 
+    glass_to_aim.record(steady_clock::now() - timestamp);
+
     /// 发射逻辑
     command.shoot = shooter.shoot(command, aimer, targets, gimbal_pos);
 
-    cboard.send(command);
+    // 全向感知的指令没有对应的Target，直接转发
+    std::optional<auto_aim::TargetSnapshot> snapshot;
+    if (tracker.state() != "lost" && !targets.empty() && aimer.debug_aim_point.valid)
+      snapshot = targets.front().snapshot();
+    streamer.update(
+      command, snapshot, aimer.debug_aim_point.xyza, cboard.bullet_speed, timestamp);
 
     /// ROS2通信
     Eigen::Vector4d target_info = decider.get_target_info(armors, targets);
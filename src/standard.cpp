@@ -8,6 +8,7 @@
 //#include "io/cboard.hpp"
 #include "io/gimbal/gimbal.hpp"//修改为串口
 #include "tasks/auto_aim/aimer.hpp"
+#include "tasks/auto_aim/command_streamer.hpp"
 #include "tasks/auto_aim/multithread/commandgener.hpp"
 #include "tasks/auto_aim/shooter.hpp"
 #include "tasks/auto_aim/solver.hpp"
@@ -15,15 +16,19 @@
 #include "tasks/auto_aim/yolo.hpp"
 #include "tools/exiter.hpp"
 #include "tools/img_tools.hpp"
+#include "tools/latency_histogram.hpp"
 #include "tools/logger.hpp"
 #include "tools/math_tools.hpp"
 #include "tools/plotter.hpp"
 #include "tools/recorder.hpp"
+#include "tools/telemetry.hpp"
+#include "tools/tracer.hpp"
 
 using namespace std::chrono;
 
 const std::string keys =
   "{help h usage ? |      | 输出命令行参数说明}"
+  "{trace          |      | 退出时保存Chrome trace的路径，为空时不保存}"
   "{@config-path   | configs/standard3.yaml | 位置参数，yaml配置文件路径 }";
 
 int main(int argc, char * argv[])
@@ -34,10 +39,20 @@ int main(int argc, char * argv[])
     cli.printMessage();
     return 0;
   }
+  auto trace_path = cli.get<std::string>("trace");
 
   tools::Exiter exiter;
   tools::Plotter plotter;
   tools::Recorder recorder;
+  tools::Telemetry telemetry;
+
+  // 各阶段相对相机帧时间戳的延迟，glass_to_command为指令发出时所依据的帧已过去的时间
+  tools::LatencyMonitor latency(1s, &telemetry);
+  auto & glass_to_read = latency.histogram("glass_to_read");
+  auto & glass_to_detect = latency.histogram("glass_to_detect");
+  auto & glass_to_track = latency.histogram("glass_to_track");
+  auto & glass_to_aim = latency.histogram("glass_to_aim");
+  auto & glass_to_command = latency.histogram("glass_to_command");
 
   //io::CBoard cboard(config_path);
   io::Gimbal gimbal(config_path);
@@ -49,6 +64,14 @@ int main(int argc, char * argv[])
   auto_aim::Aimer aimer(config_path);
   auto_aim::Shooter shooter(config_path);
 
+  // 云台设定值由发送线程以stream_rate更新，与相机帧率无关
+  auto_aim::CommandStreamer streamer(config_path, [&](const auto_aim::StreamCommand & c) {
+    gimbal.send(c.control, c.shoot, c.yaw, c.yaw_vel, 0.0f, c.pitch, c.pitch_vel, 0.0f);
+    // 第一次update之前frame_time为零点，不控制时的指令不依据任何帧，均不计入
+    if (c.control && c.frame_time != steady_clock::time_point{})
+      glass_to_command.record(steady_clock::now() - c.frame_time);
+  });
+
   cv::Mat img;
   Eigen::Quaterniond q;
   std::chrono::steady_clock::time_point t;
@@ -58,8 +81,12 @@ int main(int argc, char * argv[])
   auto mode = io::GimbalMode::IDLE;
   auto last_mode = io::GimbalMode::IDLE;
 
+  TOOLS_TRACE_THREAD("main");
+
   while (!exiter.exit()) {
     camera.read(img, t);
+    TOOLS_TRACE_FRAME(t);
+    glass_to_read.record(steady_clock::now() - t);
     //q = cboard.imu_at(t - 1ms);
     //mode = cboard.mode;
     q = gimbal.q(t);
@@ -78,16 +105,26 @@ int main(int argc, char * argv[])
 
     Eigen::Vector3d ypr = tools::eulers(solver.R_gimbal2world(), 2, 1, 0);
 
-    auto armors = detector.detect(img);
+    auto armors = TOOLS_TRACE_CALL("yolo.detect", detector.detect(img));
+    glass_to_detect.record(steady_clock::now() - t);
 
-    auto targets = tracker.track(armors, t);
+    auto targets = TOOLS_TRACE_CALL("tracker.track", tracker.track(armors, t));
+    glass_to_track.record(steady_clock::now() - t);
 
-    auto command = aimer.aim(targets, t, gs.bullet_speed);
+    auto command = TOOLS_TRACE_CALL("aimer.aim", aimer.aim(targets, t, gs.bullet_speed));
+    glass_to_aim.record(steady_clock::now() - t);
     //auto command = aimer.aim(targets, t, cboard.bullet_speed);
 
+    std::optional<auto_aim::TargetSnapshot> snapshot;
+    if (!targets.empty() && aimer.debug_aim_point.valid) snapshot = targets.front().snapshot();
+
     //cboard.send(command);
-    gimbal.send(command.control, command.shoot, command.yaw, 0.0f, 0.0f, command.pitch, 0.0f, 0.0f);
+    TOOLS_TRACE_CALL(
+      "streamer.update",
+      streamer.update(command, snapshot, aimer.debug_aim_point.xyza, gs.bullet_speed, t));
   }
 
+  if (!trace_path.empty()) tools::trace::save(trace_path);
+
   return 0;
 }
\ No newline at end of file
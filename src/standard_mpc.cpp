@@ -17,13 +17,18 @@
 #include "tasks/auto_buff/buff_type.hpp"
 #include "tools/exiter.hpp"
 #include "tools/img_tools.hpp"
+#include "tools/latency_histogram.hpp"
 #include "tools/logger.hpp"
 #include "tools/math_tools.hpp"
+#include "tools/periodic_executor.hpp"
 #include "tools/plotter.hpp"
 #include "tools/recorder.hpp"
+#include "tools/telemetry.hpp"
+#include "tools/tracer.hpp"
 
 const std::string keys =
   "{help h usage ? | | 输出命令行参数说明}"
+  "{trace          | | 退出时保存Chrome trace的路径，为空时不保存}"
   "{@config-path   | | yaml配置文件路径 }";
 
 using namespace std::chrono_literals;
@@ -36,10 +41,12 @@ int main(int argc, char * argv[])
     cli.printMessage();
     return 0;
   }
+  auto trace_path = cli.get<std::string>("trace");
 
   tools::Exiter exiter;
   tools::Plotter plotter;
   tools::Recorder recorder;
+  tools::Telemetry telemetry;
 
   io::Gimbal gimbal(config_path);
   io::Camera camera(config_path);
@@ -49,7 +56,7 @@ int main(int argc, char * argv[])
   auto_aim::Tracker tracker(config_path, solver);
   auto_aim::Planner planner(config_path);
 
-  tools::ThreadSafeQueue<std::optional<auto_aim::Target>, true> target_queue(1);
+  tools::ThreadSafeQueue<std::optional<auto_aim::TargetSnapshot>, true> target_queue(1);
   target_queue.push(std::nullopt);
 
   auto_buff::Buff_Detector buff_detector(config_path);
@@ -62,31 +69,39 @@ int main(int argc, char * argv[])
   Eigen::Quaterniond q;
   std::chrono::steady_clock::time_point t;
 
-  std::atomic<bool> quit = false;
-
   std::atomic<io::GimbalMode> mode{io::GimbalMode::IDLE};
   auto last_mode{io::GimbalMode::IDLE};
 
+  // 各阶段相对相机帧时间戳的延迟，glass_to_command为指令发出时所依据的帧已过去的时间
+  tools::LatencyMonitor latency(1s, &telemetry);
+  auto & glass_to_detect = latency.histogram("glass_to_detect");
+  auto & glass_to_track = latency.histogram("glass_to_track");
+  auto & glass_to_command = latency.histogram("glass_to_command");
+
+  // 非自瞄模式下空转，切回自瞄时无需等待
+  tools::PeriodicExecutor executor(10ms);
   auto plan_thread = std::thread([&]() {
-    auto t0 = std::chrono::steady_clock::now();
-    uint16_t last_bullet_count = 0;
-
-    while (!quit) {
-      if (!target_queue.empty() && mode == io::GimbalMode::AUTO_AIM) {
-        auto target = target_queue.front();
-        auto gs = gimbal.state();
-        auto plan = planner.plan(target, gs.bullet_speed);
-
-        gimbal.send(
-          plan.control, plan.fire, plan.yaw, plan.yaw_vel, plan.yaw_acc, plan.pitch, plan.pitch_vel,
-          plan.pitch_acc);
-
-        std::this_thread::sleep_for(10ms);
-      } else
-        std::this_thread::sleep_for(200ms);
-    }
+    TOOLS_TRACE_THREAD("plan");
+
+    executor.run([&] {
+      if (target_queue.empty() || mode != io::GimbalMode::AUTO_AIM) return;
+
+      // 规划所依据的帧，无目标时为0
+      auto target = target_queue.front();
+      TOOLS_TRACE_FRAME(target ? target->t : std::chrono::steady_clock::time_point{});
+      auto gs = gimbal.state();
+      auto plan = planner.plan(target, gs.bullet_speed);
+
+      TOOLS_TRACE_SPAN("gimbal.send");
+      gimbal.send(
+        plan.control, plan.fire, plan.yaw, plan.yaw_vel, plan.yaw_acc, plan.pitch, plan.pitch_vel,
+        plan.pitch_acc);
+      if (plan.control) glass_to_command.record(std::chrono::steady_clock::now() - plan.frame_time);
+    });
   });
 
+  TOOLS_TRACE_THREAD("main");
+
   while (!exiter.exit()) {
     mode = gimbal.mode();
 
@@ -96,17 +111,20 @@ int main(int argc, char * argv[])
     }
 
     camera.read(img, t);
+    TOOLS_TRACE_FRAME(t);
     auto q = gimbal.q(t);
     auto gs = gimbal.state();
-    recorder.record(img, q, t);
+    TOOLS_TRACE_CALL("recorder.record", recorder.record(img, q, t));
     solver.set_R_gimbal2world(q);
 
     /// 自瞄
     if (mode.load() == io::GimbalMode::AUTO_AIM) {
-      auto armors = yolo.detect(img);
-      auto targets = tracker.track(armors, t);
+      auto armors = TOOLS_TRACE_CALL("yolo.detect", yolo.detect(img));
+      glass_to_detect.record(std::chrono::steady_clock::now() - t);
+      auto targets = TOOLS_TRACE_CALL("tracker.track", tracker.track(armors, t));
+      glass_to_track.record(std::chrono::steady_clock::now() - t);
       if (!targets.empty())
-        target_queue.push(targets.front());
+        target_queue.push(targets.front().snapshot());
       else
         target_queue.push(std::nullopt);
     }
@@ -115,7 +133,7 @@ int main(int argc, char * argv[])
     else if (mode.load() == io::GimbalMode::SMALL_BUFF || mode.load() == io::GimbalMode::BIG_BUFF) {
       buff_solver.set_R_gimbal2world(q);
 
-      auto power_runes = buff_detector.detect(img);
+      auto power_runes = TOOLS_TRACE_CALL("buff_detector.detect", buff_detector.detect(img));
 
       buff_solver.solve(power_runes);
 
@@ -137,9 +155,11 @@ int main(int argc, char * argv[])
       gimbal.send(false, false, 0, 0, 0, 0, 0, 0);
   }
 
-  quit = true;
+  executor.stop();
   if (plan_thread.joinable()) plan_thread.join();
   gimbal.send(false, false, 0, 0, 0, 0, 0, 0);
+  tools::logger()->info("[Plan] {}", executor.summary());
+  if (!trace_path.empty()) tools::trace::save(trace_path);
 
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "command_streamer.hpp"
+
+#include <cmath>
+#include <utility>
+
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/yaml.hpp"
+
+namespace auto_aim
+{
+// 超过该时间未收到新快照时不再外推，保持最后的设定值且不发弹
+constexpr double MAX_EXTRAPOLATION = 0.2;  // s
+
+CommandStreamer::CommandStreamer(const std::string & config_path, Sender sender)
+: sender_(std::move(sender)),
+  input_{io::Command{false, false, 0, 0}, std::nullopt, -1, 0.0, {}},
+  last_{false, false, 0, 0, 0, 0, {}}
+{
+  auto yaml = tools::load(config_path);
+  yaw_offset_ = tools::read<double>(yaml, "yaw_offset") / 57.3;      // degree to rad
+  pitch_offset_ = tools::read<double>(yaml, "pitch_offset") / 57.3;  // degree to rad
+  decision_speed_ = tools::read<double>(yaml, "decision_speed");
+  high_speed_delay_time_ = tools::read<double>(yaml, "high_speed_delay_time");
+  low_speed_delay_time_ = tools::read<double>(yaml, "low_speed_delay_time");
+  auto stream_rate = tools::read<double>(yaml, "stream_rate");
+  ballistic_table_ = tools::BallisticTable::from_config(config_path);
+
+  executor_ = std::make_unique<tools::PeriodicExecutor>(
+    std::chrono::nanoseconds(static_cast<int64_t>(1e9 / stream_rate)));
+  thread_ = std::thread([this] { executor_->run([this] { stream(); }); });
+
+  tools::logger()->info("[CommandStreamer] Streaming at {:.0f}Hz", stream_rate);
+}
+
+CommandStreamer::~CommandStreamer()
+{
+  executor_->stop();
+  if (thread_.joinable()) thread_.join();
+  tools::logger()->info("[CommandStreamer] {}", executor_->summary());
+}
+
+void CommandStreamer::update(
+  const io::Command & command, const std::optional<TargetSnapshot> & target,
+  const Eigen::Vector4d & aim_xyza, double bullet_speed,
+  std::chrono::steady_clock::time_point frame_time)
+{
+  auto armor_id = -1;
+  if (command.control && target.has_value())
+    armor_id = match_armor(*target, aim_xyza, bullet_speed);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  input_ = {command, target, armor_id, bullet_speed, frame_time};
+}
+
+tools::PeriodicExecutor::Stats CommandStreamer::stats() const { return executor_->stats(); }
+
+double CommandStreamer::delay_time(const TargetSnapshot & target) const
+{
+  return std::abs(target.x[7]) > decision_speed_ ? high_speed_delay_time_ : low_speed_delay_time_;
+}
+
+// Aimer的瞄准点对应其预测的命中时刻，将快照外推到同一时刻后朝向最接近的装甲板即为所瞄准的装甲板
+// 瞄准点的弹道不可解时返回-1，发送线程直接转发原指令
+int CommandStreamer::match_armor(
+  const TargetSnapshot & target, const Eigen::Vector4d & aim_xyza, double bullet_speed) const
+{
+  auto d = std::hypot(aim_xyza[0], aim_xyza[1]);
+  auto trajectory = tools::solve_trajectory(ballistic_table_, bullet_speed, d, aim_xyza[2]);
+  if (trajectory.unsolvable) return -1;
+  auto t = tools::delta_time(std::chrono::steady_clock::now(), target.t) + delay_time(target);
+
+  ArmorsPrediction prediction;
+  target.predict_armors(t + trajectory.fly_time, 0.0, 1, prediction);
+
+  auto best = -1;
+  auto min_error = 1e9;
+  for (int id = 0; id < prediction.armor_num; id++) {
+    auto error = std::abs(tools::limit_rad(prediction.a(id, 0) - aim_xyza[3]));
+    if (error < min_error) {
+      best = id;
+      min_error = error;
+    }
+  }
+  return best;
+}
+
+// 返回t时刻开火时的yaw和弹道pitch（抬头为正），t为相对快照时刻的时间
+std::optional<Eigen::Vector2d> CommandStreamer::aim(
+  const TargetSnapshot & target, int armor_id, double t, double bullet_speed)
+{
+  // 与Aimer相同，迭代求解子弹飞行时间
+  auto fly_time = 0.0;
+  auto pitch = 0.0;
+  for (int i = 0; i < 3; i++) {
+    target.predict_armors(t + fly_time, 0.0, 1, prediction_);
+    auto d = std::hypot(prediction_.x(armor_id, 0), prediction_.y(armor_id, 0));
+    auto trajectory =
+      tools::solve_trajectory(ballistic_table_, bullet_speed, d, prediction_.z(armor_id, 0));
+    if (trajectory.unsolvable) return std::nullopt;
+    fly_time = trajectory.fly_time;
+    pitch = trajectory.pitch;
+  }
+
+  return Eigen::Vector2d{std::atan2(prediction_.y(armor_id, 0), prediction_.x(armor_id, 0)), pitch};
+}
+
+void CommandStreamer::stream()
+{
+  Input input;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    input = input_;
+  }
+
+  const auto & command = input.command;
+  auto forward = StreamCommand{
+    command.control, command.shoot, command.yaw, 0, command.pitch, 0, input.frame_time};
+
+  if (!command.control || !input.target.has_value() || input.armor_id < 0) {
+    last_ = forward;
+    sender_(last_);
+    return;
+  }
+
+  const auto & target = *input.target;
+  auto t = tools::delta_time(std::chrono::steady_clock::now(), target.t);
+  if (t > MAX_EXTRAPOLATION) {
+    last_.shoot = false;
+    last_.yaw_vel = 0;
+    last_.pitch_vel = 0;
+    sender_(last_);
+    return;
+  }
+
+  // 速度前馈由前后各一个周期的中心差分得到
+  auto h = std::chrono::duration<double>(executor_->period()).count();
+  auto t_hit = t + delay_time(target);
+  auto yaw_pitch_last = aim(target, input.armor_id, t_hit - h, input.bullet_speed);
+  auto yaw_pitch = aim(target, input.armor_id, t_hit, input.bullet_speed);
+  auto yaw_pitch_next = aim(target, input.armor_id, t_hit + h, input.bullet_speed);
+  if (!yaw_pitch_last || !yaw_pitch || !yaw_pitch_next) {
+    last_ = forward;
+    sender_(last_);
+    return;
+  }
+
+  last_.control = true;
+  last_.shoot = command.shoot;
+  last_.yaw = tools::limit_rad((*yaw_pitch)(0) + yaw_offset_);
+  last_.yaw_vel = tools::limit_rad((*yaw_pitch_next)(0) - (*yaw_pitch_last)(0)) / (2 * h);
+  last_.pitch = -((*yaw_pitch)(1) + pitch_offset_);
+  last_.pitch_vel = -((*yaw_pitch_next)(1) - (*yaw_pitch_last)(1)) / (2 * h);
+  last_.frame_time = input.frame_time;
+  sender_(last_);
+}
+
+}  // namespace auto_aim
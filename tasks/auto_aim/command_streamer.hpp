@@ -0,0 +1,91 @@
+#ifndef AUTO_AIM__COMMAND_STREAMER_HPP
+#define AUTO_AIM__COMMAND_STREAMER_HPP
+
+#include <Eigen/Dense>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "io/cboard.hpp"
+#include "target_snapshot.hpp"
+#include "tools/ballistic_table.hpp"
+#include "tools/periodic_executor.hpp"
+
+namespace auto_aim
+{
+struct StreamCommand
+{
+  bool control;
+  bool shoot;
+  double yaw;
+  double yaw_vel;
+  double pitch;
+  double pitch_vel;
+  std::chrono::steady_clock::time_point frame_time;  // 所依据的相机帧时间戳，用于统计延迟
+};
+
+// 与视觉帧率解耦的高频指令发送
+// 视觉线程每帧调用update提交最新的Target快照和Aimer的指令，发送线程以固定频率用解析运动模型
+// 把快照外推到当前时刻，重新计算所瞄准装甲板的yaw/pitch及其速度前馈，再通过sender发给电控
+// 推理变慢或丢帧时云台设定值仍按stream_rate连续更新
+class CommandStreamer
+{
+public:
+  using Sender = std::function<void(const StreamCommand &)>;
+
+  CommandStreamer(const std::string & config_path, Sender sender);
+  ~CommandStreamer();
+
+  // command Aimer（或全向感知）给出的指令，control为false或target为空时直接转发
+  // aim_xyza Aimer所瞄准装甲板的位置和朝向，用于在快照中确定外推哪一块装甲板
+  // frame_time 得出该指令的相机帧时间戳，随之后发送的每条指令传给sender
+  void update(
+    const io::Command & command, const std::optional<TargetSnapshot> & target,
+    const Eigen::Vector4d & aim_xyza, double bullet_speed,
+    std::chrono::steady_clock::time_point frame_time);
+
+  tools::PeriodicExecutor::Stats stats() const;
+
+private:
+  struct Input
+  {
+    io::Command command;
+    std::optional<TargetSnapshot> target;
+    int armor_id;
+    double bullet_speed;
+    std::chrono::steady_clock::time_point frame_time;
+  };
+
+  double yaw_offset_;
+  double pitch_offset_;
+  double decision_speed_;
+  double high_speed_delay_time_;
+  double low_speed_delay_time_;
+  std::shared_ptr<const tools::BallisticTable> ballistic_table_;
+
+  Sender sender_;
+  std::unique_ptr<tools::PeriodicExecutor> executor_;
+  std::thread thread_;
+
+  std::mutex mutex_;
+  Input input_;
+
+  // 以下仅由发送线程访问
+  StreamCommand last_;
+  ArmorsPrediction prediction_;
+
+  double delay_time(const TargetSnapshot & target) const;
+  int match_armor(
+    const TargetSnapshot & target, const Eigen::Vector4d & aim_xyza, double bullet_speed) const;
+  std::optional<Eigen::Vector2d> aim(
+    const TargetSnapshot & target, int armor_id, double t, double bullet_speed);
+  void stream();
+};
+
+}  // namespace auto_aim
+
+#endif  // AUTO_AIM__COMMAND_STREAMER_HPP
@@ -0,0 +1,222 @@
+#include "multi_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "target_model.hpp"
+#include "tools/hungarian.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/yaml.hpp"
+
+namespace auto_aim
+{
+MultiTracker::MultiTracker(const std::string & config_path, Solver & solver)
+: solver_{solver}, next_id_{0}
+{
+  auto yaml = tools::load(config_path);
+  enemy_color_ =
+    (tools::read<std::string>(yaml, "enemy_color") == "red") ? Color::red : Color::blue;
+  min_detect_count_ = tools::read<int>(yaml, "min_detect_count");
+  max_lost_count_ = tools::read<int>(yaml, "max_temp_lost_count");
+  outpost_max_lost_count_ = tools::read<int>(yaml, "outpost_max_temp_lost_count");
+  gate_ = tools::read<double>(yaml, "multi_tracker_gate");
+  auto R_dig = tools::read<std::vector<double>>(yaml, "multi_tracker_R");
+  R_dig_ = Eigen::Vector4d(R_dig.data());
+}
+
+std::list<Target> MultiTracker::track(
+  std::list<Armor> & armors, std::chrono::steady_clock::time_point t)
+{
+  armors.remove_if([&](const Armor & a) { return a.color != enemy_color_; });
+
+  std::vector<Armor *> observations;
+  for (auto & armor : armors) {
+    solver_.solve(armor);
+    observations.push_back(&armor);
+  }
+
+  // 1. 批量预测
+  for (auto & track : tracks_) {
+    track.target.predict(t);
+    track.updated = false;
+  }
+
+  // 2. 一次性求解全部航迹与装甲板的指派
+  constexpr double infeasible = 1e9;
+  Eigen::MatrixXd cost(tracks_.size(), observations.size());
+  for (size_t i = 0; i < tracks_.size(); i++)
+    for (size_t j = 0; j < observations.size(); j++)
+      cost(i, j) = gate_cost(tracks_[i], *observations[j]);
+  auto assignment = tools::hungarian(cost, infeasible);
+
+  // 3. 批量更新
+  std::vector<bool> used(observations.size(), false);
+  for (size_t i = 0; i < tracks_.size(); i++) {
+    auto & track = tracks_[i];
+    if (assignment[i] < 0) {
+      track.lost_count++;
+      continue;
+    }
+    used[assignment[i]] = true;
+    track.target.update(*observations[assignment[i]]);
+    track.updated = true;
+    track.detect_count++;
+    track.lost_count = 0;
+  }
+
+  // 4. 删除丢失或发散的航迹
+  tracks_.erase(
+    std::remove_if(
+      tracks_.begin(), tracks_.end(),
+      [&](const Track & track) {
+        auto max_lost =
+          (track.target.name == ArmorName::outpost) ? outpost_max_lost_count_ : max_lost_count_;
+        return track.lost_count > max_lost || track.target.diverged();
+      }),
+    tracks_.end());
+
+  // 5. 未关联的装甲板新建航迹
+  // 同一兵种的航迹本帧已更新时不新建，避免同一机器人的第二块装甲板产生重复航迹
+  // 同一兵种的航迹本帧未更新，说明观测未通过门限（如目标跳变），沿用id重新初始化该航迹
+  for (size_t j = 0; j < observations.size(); j++) {
+    if (used[j]) continue;
+    const auto & armor = *observations[j];
+    auto same = std::find_if(tracks_.begin(), tracks_.end(), [&](const Track & track) {
+      return track.target.name == armor.name;
+    });
+    if (same == tracks_.end()) {
+      tracks_.push_back({next_id_++, make_target(armor, t), 1, 0, true});
+      continue;
+    }
+    if (same->updated) continue;
+
+    tools::logger()->debug("MultiTracker reinit {} (track {})", ARMOR_NAMES[armor.name], same->id);
+    same->target = make_target(armor, t);
+    same->detect_count = 1;
+    same->lost_count = 0;
+    same->updated = true;
+  }
+
+  reselect();
+
+  if (!selected_id_.has_value()) return {};
+  for (const auto & track : tracks_)
+    if (track.id == *selected_id_) return {track.target};
+  return {};
+}
+
+bool MultiTracker::select(ArmorName name)
+{
+  for (const auto & track : tracks_) {
+    if (track.target.name != name || !confirmed(track)) continue;
+    if (selected_id_ != track.id)
+      tools::logger()->debug("MultiTracker switch to {} (track {})", ARMOR_NAMES[name], track.id);
+    selected_id_ = track.id;
+    return true;
+  }
+  return false;
+}
+
+std::string MultiTracker::state() const { return selected_id_.has_value() ? "tracking" : "lost"; }
+
+const std::vector<MultiTracker::Track> & MultiTracker::tracks() const { return tracks_; }
+
+bool MultiTracker::confirmed(const Track & track) const
+{
+  return track.detect_count >= min_detect_count_;
+}
+
+double MultiTracker::gate_cost(const Track & track, const Armor & armor) const
+{
+  constexpr double infeasible = 1e9;
+  if (track.target.name != armor.name) return infeasible;
+
+  auto snapshot = track.target.snapshot();
+  Eigen::Matrix<double, TARGET_STATE_DIM, 1> x = snapshot.ekf_x();
+  const Eigen::MatrixXd & P = track.target.ekf().P;
+
+  Eigen::Vector4d z{
+    armor.ypd_in_world[0], armor.ypd_in_world[1], armor.ypd_in_world[2], armor.ypr_in_world[0]};
+
+  // 对航迹的每一块装甲板求马氏距离，取最小值
+  auto min_d2 = std::numeric_limits<double>::infinity();
+  for (int id = 0; id < snapshot.armor_num; id++) {
+    Eigen::Vector4d z_pred;
+    Eigen::Matrix<double, 4, TARGET_STATE_DIM> H = tools::jacobian<4, TARGET_STATE_DIM>(
+      [&](const auto & state) { return model::h_armor_ypda(state, id, snapshot.armor_num); }, x,
+      &z_pred);
+
+    Eigen::Vector4d residual = z - z_pred;
+    residual[0] = tools::limit_rad(residual[0]);
+    residual[3] = tools::limit_rad(residual[3]);
+
+    Eigen::Matrix4d S = H * P * H.transpose();
+    S.diagonal() += R_dig_;
+    min_d2 = std::min(min_d2, residual.dot(S.ldlt().solve(residual)));
+  }
+
+  return min_d2 < gate_ ? min_d2 : infeasible;
+}
+
+Target MultiTracker::make_target(const Armor & armor, std::chrono::steady_clock::time_point t) const
+{
+  // 初始化参数与Tracker保持一致
+  auto is_balance = (armor.type == ArmorType::big) &&
+                    (armor.name == ArmorName::three || armor.name == ArmorName::four ||
+                     armor.name == ArmorName::five);
+
+  if (is_balance) {
+    Eigen::VectorXd P0_dig{{1, 64, 1, 64, 1, 64, 0.4, 100, 1, 1, 1}};
+    return Target(armor, t, 0.2, 2, P0_dig);
+  }
+
+  if (armor.name == ArmorName::outpost) {
+    Eigen::VectorXd P0_dig{{1, 64, 1, 64, 1, 81, 0.4, 100, 1e-4, 0, 0}};
+    return Target(armor, t, 0.2765, 3, P0_dig);
+  }
+
+  if (armor.name == ArmorName::base) {
+    Eigen::VectorXd P0_dig{{1, 64, 1, 64, 1, 64, 0.4, 100, 1e-4, 0, 0}};
+    return Target(armor, t, 0.3205, 3, P0_dig);
+  }
+
+  Eigen::VectorXd P0_dig{{1, 64, 1, 64, 1, 64, 0.4, 100, 1, 1, 1}};
+  return Target(armor, t, 0.2, 4, P0_dig);
+}
+
+void MultiTracker::reselect()
+{
+  // 当前目标仍存在且已确认则保持不变
+  for (const auto & track : tracks_)
+    if (track.id == selected_id_ && confirmed(track)) return;
+
+  // 否则在已确认的航迹中按优先级、距离选择
+  const Track * best = nullptr;
+  for (const auto & track : tracks_) {
+    if (!confirmed(track)) continue;
+    if (best == nullptr) {
+      best = &track;
+      continue;
+    }
+    auto x = track.target.ekf_x(), best_x = best->target.ekf_x();
+    auto closer = std::hypot(x[0], x[2]) < std::hypot(best_x[0], best_x[2]);
+    if (
+      track.target.priority < best->target.priority ||
+      (track.target.priority == best->target.priority && closer))
+      best = &track;
+  }
+
+  if (best == nullptr) {
+    selected_id_.reset();
+    return;
+  }
+
+  if (selected_id_.has_value())
+    tools::logger()->debug(
+      "MultiTracker switch to {} (track {})", ARMOR_NAMES[best->target.name], best->id);
+  selected_id_ = best->id;
+}
+
+}  // namespace auto_aim
@@ -0,0 +1,64 @@
+#ifndef AUTO_AIM__MULTI_TRACKER_HPP
+#define AUTO_AIM__MULTI_TRACKER_HPP
+
+#include <Eigen/Dense>
+#include <chrono>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "armor.hpp"
+#include "solver.hpp"
+#include "target.hpp"
+
+namespace auto_aim
+{
+// 同时维护多个Target的跟踪器
+// 每帧先批量预测所有航迹，再对全部装甲板做一次基于马氏距离门限的匈牙利指派，最后批量更新
+// 切换目标只是在已收敛的航迹中重新选择，不需要重新初始化滤波器
+class MultiTracker
+{
+public:
+  struct Track
+  {
+    int id;
+    Target target;
+    int detect_count;
+    int lost_count;
+    bool updated;  // 本帧是否被关联到装甲板
+  };
+
+  MultiTracker(const std::string & config_path, Solver & solver);
+
+  // 返回当前选中的目标，接口与Tracker::track一致
+  std::list<Target> track(std::list<Armor> & armors, std::chrono::steady_clock::time_point t);
+
+  // 切换到指定兵种的航迹，该航迹不存在或尚未确认时返回false
+  bool select(ArmorName name);
+
+  std::string state() const;
+  const std::vector<Track> & tracks() const;
+
+private:
+  Solver & solver_;
+  Color enemy_color_;
+  int min_detect_count_;
+  int max_lost_count_;
+  int outpost_max_lost_count_;
+  double gate_;  // 马氏距离平方门限
+  Eigen::Vector4d R_dig_;
+
+  int next_id_;
+  std::optional<int> selected_id_;
+  std::vector<Track> tracks_;
+
+  bool confirmed(const Track & track) const;
+  double gate_cost(const Track & track, const Armor & armor) const;
+  Target make_target(const Armor & armor, std::chrono::steady_clock::time_point t) const;
+  void reselect();
+};
+
+}  // namespace auto_aim
+
+#endif  // AUTO_AIM__MULTI_TRACKER_HPP
@@ -0,0 +1,382 @@
+#ifndef AUTO_AIM__BATCH_SOLVER_HPP
+#define AUTO_AIM__BATCH_SOLVER_HPP
+
+#include <Eigen/Dense>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+#include "tiny_solver.hpp"
+
+namespace tinympc
+{
+// 同时求解K个结构相同、参数不同的TinyMPC问题，如yaw和pitch，或多个候选装甲板
+// 每个标量按K个通道连续存放（第i步第j个状态位于第i*NX+j列），前向/反向传播、松弛和对偶变量的更新对K个问题一次完成，
+// 由编译器向量化为SIMD指令
+// 每个通道的迭代与TinySolver<NX, NU, N, Constraints>完全一致，收敛的通道保存当时的解，不受其余通道继续迭代的影响
+template <int NX, int NU, int N, int K, unsigned Constraints = INPUT_BOUND>
+class BatchSolver
+{
+public:
+  static constexpr int lanes = K;
+  static constexpr bool en_state_bound = Constraints & STATE_BOUND;
+  static constexpr bool en_input_bound = Constraints & INPUT_BOUND;
+
+  using Problem = TinySolver<NX, NU, N, Constraints>;
+  using Lanes = Eigen::Array<double, K, 1>;
+  using LaneMask = Eigen::Array<bool, K, 1>;
+  template <int Cols>
+  using LaneArray = Eigen::Array<double, K, Cols>;
+  using StateTrajectory = LaneArray<NX * N>;
+  using InputTrajectory = LaneArray<NU * (N - 1)>;
+
+  struct Settings
+  {
+    double abs_pri_tol = 1e-3;
+    double abs_dua_tol = 1e-3;
+    int max_iter = 1000;
+    int check_termination = 1;
+  };
+
+  // 矩阵均按行优先展开，如Kinf(a, j)位于第a*NX+j列
+  struct Cache
+  {
+    Lanes rho;
+    LaneArray<NU * NX> Kinf;
+    LaneArray<NX * NX> Pinf;
+    LaneArray<NU * NU> Quu_inv;
+    LaneArray<NX * NX> AmBKt;
+    LaneArray<NX> APf;
+    LaneArray<NU> BPf;
+  };
+
+  struct Workspace
+  {
+    StateTrajectory x, q, p, v;
+    InputTrajectory u, r, d, z, znew, y;
+    detail::Optional<en_state_bound, StateTrajectory> vnew, g;
+
+    StateTrajectory Xref;
+    InputTrajectory Uref;
+
+    detail::Optional<en_state_bound, StateTrajectory> x_min, x_max;
+    detail::Optional<en_input_bound, InputTrajectory> u_min, u_max;
+
+    LaneArray<NX> Q;
+    LaneArray<NU> R;
+    LaneArray<NX * NX> Adyn;
+    LaneArray<NX * NU> Bdyn;
+    LaneArray<NX> fdyn;
+
+    // 最近一次检查终止条件时各通道的残差
+    Lanes primal_residual_state, primal_residual_input;
+    Lanes dual_residual_state, dual_residual_input;
+
+    int iter;
+  };
+
+  struct Solution
+  {
+    typename Problem::StateTrajectory x;
+    typename Problem::InputTrajectory u;
+    int iter;
+    bool solved;
+  };
+
+  Settings settings;
+  Cache cache;
+  Workspace work;
+  std::array<Solution, K> solution;
+
+  BatchSolver()
+  {
+    work.x.setZero();
+    work.q.setZero();
+    work.p.setZero();
+    work.v.setZero();
+    work.u.setZero();
+    work.r.setZero();
+    work.d.setZero();
+    work.z.setZero();
+    work.znew.setZero();
+    work.y.setZero();
+    if constexpr (en_state_bound) {
+      work.vnew.setZero();
+      work.g.setZero();
+    }
+    work.Xref.setZero();
+    work.Uref.setZero();
+    work.primal_residual_state.setZero();
+    work.primal_residual_input.setZero();
+    work.dual_residual_state.setZero();
+    work.dual_residual_input.setZero();
+    work.iter = 0;
+    done_.setConstant(false);
+  }
+
+  // 用已完成setup（及约束设置）的标量求解器初始化第lane个通道
+  void setup(int lane, const Problem & problem)
+  {
+    const auto & w = problem.work;
+    for (int j = 0; j < NX; j++) {
+      work.Q(lane, j) = w.Q(j);
+      work.fdyn(lane, j) = w.fdyn(j);
+      for (int k = 0; k < NX; k++) work.Adyn(lane, j * NX + k) = w.Adyn(j, k);
+      for (int a = 0; a < NU; a++) work.Bdyn(lane, j * NU + a) = w.Bdyn(j, a);
+    }
+    for (int a = 0; a < NU; a++) work.R(lane, a) = w.R(a);
+    copy_cache(lane, problem.cache);
+
+    if constexpr (en_state_bound) {
+      lane_map<NX>(work.x_min, lane) = w.x_min;
+      lane_map<NX>(work.x_max, lane) = w.x_max;
+    }
+    if constexpr (en_input_bound) {
+      lane_map<NU>(work.u_min, lane) = w.u_min;
+      lane_map<NU>(work.u_max, lane) = w.u_max;
+    }
+  }
+
+  // 第lane个通道切换到另一个rho的缓存，与TinySolver::set_cache一致，迭代中途（iterate之间）也可调用
+  void set_cache(int lane, const typename Problem::Cache & cache)
+  {
+    load_cache(lane, cache);
+    refresh();
+  }
+
+  // 只替换缓存并换算对偶变量，多个通道切换后调用一次refresh，避免每个通道都重新反向传播
+  void load_cache(int lane, const typename Problem::Cache & cache)
+  {
+    auto rho = cache.rho;
+    auto scale = this->cache.rho(lane) / rho;
+    work.Q.row(lane) += rho - this->cache.rho(lane);
+    work.R.row(lane) += rho - this->cache.rho(lane);
+    work.y.row(lane) *= scale;
+    if constexpr (en_state_bound) work.g.row(lane) *= scale;
+    copy_cache(lane, cache);
+  }
+
+  // 按当前缓存重新计算线性代价和反向传播，未切换缓存的通道结果不变
+  void refresh()
+  {
+    update_linear_cost();
+    backward_pass_grad();
+  }
+
+  void set_x0(int lane, const typename Problem::StateVector & x0)
+  {
+    for (int j = 0; j < NX; j++) work.x(lane, j) = x0(j);
+  }
+
+  template <typename Derived>
+  void set_x_ref(int lane, const Eigen::MatrixBase<Derived> & x_ref)
+  {
+    lane_map<NX>(work.Xref, lane) = x_ref;
+  }
+
+  // 返回0表示所有通道均收敛
+  int solve()
+  {
+    begin();
+    iterate(settings.max_iter);
+    return end();
+  }
+
+  // 分段求解：begin后可多次调用iterate，最后调用end取出未收敛通道的解
+  void begin() { begin(LaneMask::Constant(true)); }
+
+  // 只求解active中的通道，其余通道视为已收敛，不参与终止判断也不保存解
+  void begin(const LaneMask & active)
+  {
+    work.iter = 0;
+    done_ = !active;
+  }
+
+  // 最多迭代max_iter次，所有通道均收敛时返回true
+  bool iterate(int max_iter)
+  {
+    for (int i = 0; i < max_iter; i++) {
+      forward_pass();
+      update_slack();
+      update_dual();
+      update_linear_cost();
+      work.iter++;
+
+      if (work.iter % settings.check_termination == 0) {
+        LaneMask converged = termination_condition() && !done_;
+        for (int lane = 0; lane < K; lane++)
+          if (converged(lane)) save(lane, true);
+        done_ = done_ || converged;
+        if (done_.all()) return true;
+      }
+
+      work.v = state_slack();
+      work.z = work.znew;
+      backward_pass_grad();
+    }
+    return false;
+  }
+
+  int end()
+  {
+    for (int lane = 0; lane < K; lane++)
+      if (!done_(lane)) save(lane, false);
+    return done_.all() ? 0 : 1;
+  }
+
+  // 本次求解中已收敛（或未启用）的通道
+  const LaneMask & done() const { return done_; }
+
+  const StateTrajectory & state_slack() const
+  {
+    if constexpr (en_state_bound)
+      return work.vnew;
+    else
+      return work.x;
+  }
+
+  // 第lane个通道的Rows行视图，可直接与标量求解器的矩阵互相赋值
+  template <int Rows, typename Array>
+  static auto lane_map(Array & array, int lane)
+  {
+    constexpr int cols = std::remove_const_t<Array>::ColsAtCompileTime / Rows;
+    using Matrix = std::conditional_t<
+      std::is_const_v<Array>, const Eigen::Matrix<double, Rows, cols>,
+      Eigen::Matrix<double, Rows, cols>>;
+    return Eigen::Map<Matrix, 0, Eigen::Stride<Rows * K, K>>(array.data() + lane);
+  }
+
+private:
+  LaneMask done_;
+
+  void copy_cache(int lane, const typename Problem::Cache & cache)
+  {
+    for (int j = 0; j < NX; j++) {
+      this->cache.APf(lane, j) = cache.APf(j);
+      for (int k = 0; k < NX; k++) {
+        this->cache.Pinf(lane, j * NX + k) = cache.Pinf(j, k);
+        this->cache.AmBKt(lane, j * NX + k) = cache.AmBKt(j, k);
+      }
+    }
+    for (int a = 0; a < NU; a++) {
+      this->cache.BPf(lane, a) = cache.BPf(a);
+      for (int j = 0; j < NX; j++) this->cache.Kinf(lane, a * NX + j) = cache.Kinf(a, j);
+      for (int b = 0; b < NU; b++) this->cache.Quu_inv(lane, a * NU + b) = cache.Quu_inv(a, b);
+    }
+    this->cache.rho(lane) = cache.rho;
+  }
+
+  void save(int lane, bool solved)
+  {
+    solution[lane].x = lane_map<NX>(std::as_const(work.x), lane);
+    solution[lane].u = lane_map<NU>(std::as_const(work.u), lane);
+    solution[lane].iter = work.iter;
+    solution[lane].solved = solved;
+  }
+
+  void backward_pass_grad()
+  {
+    for (int i = N - 2; i >= 0; i--) {
+      for (int a = 0; a < NU; a++) {
+        Lanes d = Lanes::Zero();
+        for (int b = 0; b < NU; b++) {
+          Lanes Bp = work.r.col(i * NU + b) + cache.BPf.col(b);
+          for (int j = 0; j < NX; j++)
+            Bp += work.Bdyn.col(j * NU + b) * work.p.col((i + 1) * NX + j);
+          d += cache.Quu_inv.col(a * NU + b) * Bp;
+        }
+        work.d.col(i * NU + a) = d;
+      }
+
+      for (int j = 0; j < NX; j++) {
+        Lanes p = work.q.col(i * NX + j) + cache.APf.col(j);
+        for (int k = 0; k < NX; k++)
+          p += cache.AmBKt.col(j * NX + k) * work.p.col((i + 1) * NX + k);
+        for (int a = 0; a < NU; a++) p -= cache.Kinf.col(a * NX + j) * work.r.col(i * NU + a);
+        work.p.col(i * NX + j) = p;
+      }
+    }
+  }
+
+  void forward_pass()
+  {
+    for (int i = 0; i < N - 1; i++) {
+      for (int a = 0; a < NU; a++) {
+        Lanes u = -work.d.col(i * NU + a);
+        for (int j = 0; j < NX; j++) u -= cache.Kinf.col(a * NX + j) * work.x.col(i * NX + j);
+        work.u.col(i * NU + a) = u;
+      }
+
+      for (int j = 0; j < NX; j++) {
+        Lanes x = work.fdyn.col(j);
+        for (int k = 0; k < NX; k++) x += work.Adyn.col(j * NX + k) * work.x.col(i * NX + k);
+        for (int a = 0; a < NU; a++) x += work.Bdyn.col(j * NU + a) * work.u.col(i * NU + a);
+        work.x.col((i + 1) * NX + j) = x;
+      }
+    }
+  }
+
+  void update_slack()
+  {
+    work.znew = work.u + work.y;
+    if constexpr (en_input_bound) work.znew = work.u_max.min(work.u_min.max(work.znew));
+
+    if constexpr (en_state_bound) {
+      work.vnew = work.x + work.g;
+      work.vnew = work.x_max.min(work.x_min.max(work.vnew));
+    }
+  }
+
+  void update_dual()
+  {
+    work.y += work.u - work.znew;
+    if constexpr (en_state_bound) work.g += work.x - work.vnew;
+  }
+
+  void update_linear_cost()
+  {
+    for (int c = 0; c < NU * (N - 1); c++)
+      work.r.col(c) = -work.Uref.col(c) * work.R.col(c % NU) -
+                      cache.rho * (work.znew.col(c) - work.y.col(c));
+
+    const auto & slack = state_slack();
+    for (int c = 0; c < NX * N; c++) {
+      work.q.col(c) = -work.Xref.col(c) * work.Q.col(c % NX) - cache.rho * slack.col(c);
+      if constexpr (en_state_bound) work.q.col(c) += cache.rho * work.g.col(c);
+    }
+
+    for (int j = 0; j < NX; j++) {
+      Lanes p = -cache.rho * slack.col((N - 1) * NX + j);
+      for (int k = 0; k < NX; k++)
+        p -= work.Xref.col((N - 1) * NX + k) * cache.Pinf.col(k * NX + j);
+      if constexpr (en_state_bound) p += cache.rho * work.g.col((N - 1) * NX + j);
+      work.p.col((N - 1) * NX + j) = p;
+    }
+  }
+
+  // 逐列求每个通道的最大绝对值，按列访问可向量化，rowwise()在通道维上是跨步访问
+  template <typename Derived>
+  static Lanes lane_max_abs(const Eigen::ArrayBase<Derived> & array)
+  {
+    Lanes max = array.col(0).abs();
+    for (int c = 1; c < array.cols(); c++) max = max.max(array.col(c).abs());
+    return max;
+  }
+
+  LaneMask termination_condition()
+  {
+    if constexpr (en_state_bound) work.primal_residual_state = lane_max_abs(work.x - work.vnew);
+    work.dual_residual_state = lane_max_abs(work.v - state_slack()) * cache.rho;
+    work.primal_residual_input = lane_max_abs(work.u - work.znew);
+    work.dual_residual_input = lane_max_abs(work.z - work.znew) * cache.rho;
+
+    return work.primal_residual_state < settings.abs_pri_tol &&
+           work.primal_residual_input < settings.abs_pri_tol &&
+           work.dual_residual_state < settings.abs_dua_tol &&
+           work.dual_residual_input < settings.abs_dua_tol;
+  }
+};
+
+}  // namespace tinympc
+
+#endif  // AUTO_AIM__BATCH_SOLVER_HPP
@@ -0,0 +1,31 @@
+#include "planner.hpp"
+
+#include "tools/yaml.hpp"
+
+namespace auto_aim
+{
+Planner::Planner(const std::string & config_path)
+{
+  auto yaml = tools::load(config_path);
+  yaw_offset_ = tools::read<double>(yaml, "yaw_offset") / 57.3;      // degree to rad
+  pitch_offset_ = tools::read<double>(yaml, "pitch_offset") / 57.3;  // degree to rad
+  fire_thresh_ = tools::read<double>(yaml, "fire_thresh");
+  decision_speed_ = tools::read<double>(yaml, "decision_speed");
+  high_speed_delay_time_ = tools::read<double>(yaml, "high_speed_delay_time");
+  low_speed_delay_time_ = tools::read<double>(yaml, "low_speed_delay_time");
+
+  setup_static_solvers(config_path);
+}
+
+Plan Planner::plan(Target target, double bullet_speed)
+{
+  return plan(target.snapshot(), bullet_speed);
+}
+
+Plan Planner::plan(std::optional<Target> target, double bullet_speed)
+{
+  if (!target.has_value()) return {false};
+  return plan(std::optional<TargetSnapshot>(target->snapshot()), bullet_speed);
+}
+
+}  // namespace auto_aim
@@ -2,20 +2,44 @@
 #define AUTO_AIM__PLANNER_HPP
 
 #include <Eigen/Dense>
+#include <array>
+#include <chrono>
 #include <list>
+#include <memory>
 #include <optional>
 
 #include "tasks/auto_aim/target.hpp"
-#include "tinympc/tiny_api.hpp"
+#include "tasks/auto_aim/target_snapshot.hpp"
+#include "batch_solver.hpp"
+#include "rho_cache_bank.hpp"
+#include "static_solver.hpp"
+#include "tools/ballistic_table.hpp"
 
 namespace auto_aim
 {
 constexpr double DT = 0.01;
 constexpr int HALF_HORIZON = 50;
 constexpr int HORIZON = HALF_HORIZON * 2;
+constexpr double SOLVE_BUDGET = 1.5e-3;  // 单个求解器每次规划的时间预算，单位：s
+constexpr int SOLVE_CHUNK_ITER = 2;      // 检查时间预算的迭代间隔
+constexpr double RHO_TOLERANCE = 5.0;    // 原始残差与对偶残差相差超过该倍数时调整rho
+
+static_assert(STATIC_SOLVER_HORIZON == HORIZON);
 
 using Trajectory = Eigen::Matrix<double, 4, HORIZON>;  // yaw, yaw_vel, pitch, pitch_vel
 
+// yaw和pitch放在同一个批量求解器的两个通道中联合求解
+using JointSolver = tinympc::BatchSolver<2, 1, HORIZON, 2>;
+constexpr int YAW_LANE = 0;
+constexpr int PITCH_LANE = 1;
+
+// 多假设规划：每个候选装甲板占一对yaw、pitch通道
+using HypothesisSolver = tinympc::BatchSolver<2, 1, HORIZON, 2 * MAX_ARMOR_NUM>;
+
+// 按yaw、pitch通道索引的rho缓存库，为空时不调整rho
+using RhoBank = tinympc::RhoCacheBank<StaticSolver>;
+using RhoBanks = std::array<std::shared_ptr<const RhoBank>, 2>;
+
 struct Plan
 {
   bool control;
@@ -28,31 +52,90 @@ struct Plan
   float pitch;
   float pitch_vel;
   float pitch_acc;
+  std::chrono::steady_clock::time_point frame_time;  // 所依据的相机帧时间戳，无目标时为0
+};
+
+struct SolveStats
+{
+  int iter;
+  bool solved;
+  double time_ms;
 };
 
 class Planner
 {
 public:
   Eigen::Vector4d debug_xyza;
+  SolveStats yaw_stats{}, pitch_stats{};  // 最近一次规划的求解统计
   Planner(const std::string & config_path);
 
   Plan plan(Target target, double bullet_speed);
   Plan plan(std::optional<Target> target, double bullet_speed);
 
+  // 基于快照的规划，不做堆内存分配，供规划线程使用
+  Plan plan(const TargetSnapshot & target, double bullet_speed);
+  Plan plan(const std::optional<TargetSnapshot> & target, double bullet_speed);
+
 private:
   double yaw_offset_;
   double pitch_offset_;
   double fire_thresh_;
   double low_speed_delay_time_, high_speed_delay_time_, decision_speed_;
 
-  TinySolver * yaw_solver_;
-  TinySolver * pitch_solver_;
+  // 考虑空气阻力的弹道查找表，未配置bullet_drag时为空
+  std::shared_ptr<const tools::BallisticTable> ballistic_table_;
+
+  ArmorsPrediction prediction_;
+  Eigen::Matrix<double, 2, 1> aim(const ArmorsPrediction & prediction, int i, double bullet_speed);
+  Trajectory get_trajectory(const TargetSnapshot & target, double yaw0, double bullet_speed);
+
+  // 批量瞄准：第i步瞄准ids[i]号装甲板，整个时域的坐标转换和弹道按SoA布局批量求解
+  using HorizonIds = std::array<int, HORIZON + 2>;
+  struct HorizonBuffer
+  {
+    std::array<double, HORIZON + 2> x, y, z, d, yaw, pitch, fly_time;
+  };
+  HorizonBuffer horizon_;
+
+  Trajectory aim_horizon(
+    const ArmorsPrediction & prediction, const HorizonIds & ids, double yaw0, double bullet_speed);
+
+  // 滚动时域热启动
+  std::optional<std::chrono::steady_clock::time_point> last_shift_time_;
+  std::optional<double> last_yaw0_;
+
+  int shift_steps(std::chrono::steady_clock::time_point t);
+
+  // 定长求解器，yaw和pitch联合求解，不做堆内存分配
+  // 配置哈希匹配时使用代码生成的缓存，否则在启动时计算
+  std::unique_ptr<JointSolver> joint_solver_;
+
+  // 配置adaptive_rho时，求解过程中按残差在预先计算的缓存库中切换rho
+  RhoBanks rho_banks_;
+
+  // 同时加载弹道查找表和rho缓存库
+  void setup_static_solvers(const std::string & config_path);
+  void warm_start(JointSolver & solver, int steps, double yaw0_offset);
+  double solve(JointSolver & solver);
+
+  // 多假设规划：为每个可见或即将可见的装甲板分别规划，按开火窗口长度和代价选择
+  std::unique_ptr<HypothesisSolver> hypothesis_solver_;
+  std::array<Trajectory, MAX_ARMOR_NUM> hypothesis_trajs_;
+  double comming_angle_;
+  int last_hypothesis_ = -1;
 
-  void setup_yaw_solver(const std::string & config_path);
-  void setup_pitch_solver(const std::string & config_path);
+  std::optional<Plan> plan_hypotheses(
+    const TargetSnapshot & target, double yaw0, int steps, double yaw0_offset, double bullet_speed);
+  Eigen::Matrix<double, 2, 1> aim_armor(
+    const ArmorsPrediction & prediction, int id, int i, double bullet_speed);
+  bool engageable(const ArmorsPrediction & prediction, int id, int i) const;
+  void warm_start(HypothesisSolver & solver, int steps, double yaw0_offset);
+  double solve(HypothesisSolver & solver, const HypothesisSolver::LaneMask & active);
 
-  Eigen::Matrix<double, 2, 1> aim(const Target & target, double bullet_speed);
-  Trajectory get_trajectory(Target & target, double yaw0, double bullet_speed);
+  Plan make_plan(
+    const Trajectory & traj, double yaw0, const StaticSolver::StateTrajectory & yaw_x,
+    const StaticSolver::InputTrajectory & yaw_u, const StaticSolver::StateTrajectory & pitch_x,
+    const StaticSolver::InputTrajectory & pitch_u) const;
 };
 
 }  // namespace auto_aim
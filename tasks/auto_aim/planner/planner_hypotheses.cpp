@@ -0,0 +1,113 @@
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "planner.hpp"
+#include "tools/math_tools.hpp"
+
+namespace auto_aim
+{
+std::optional<Plan> Planner::plan_hypotheses(
+  const TargetSnapshot & target, double yaw0, int steps, double yaw0_offset, double bullet_speed)
+{
+  // 第0列对应-(HALF_HORIZON+1)*DT，额外两列用于中心差分求速度，与get_trajectory一致
+  target.predict_armors(-DT * (HALF_HORIZON + 1), DT, HORIZON + 2, prediction_);
+
+  auto & solver = *hypothesis_solver_;
+  warm_start(solver, steps, yaw0_offset);
+
+  // 1. 为后半段时域内可击打的装甲板生成跟随该装甲板的轨迹
+  // 非候选装甲板（包括id不小于armor_num的）的通道不参与求解
+  std::array<bool, MAX_ARMOR_NUM> candidates{};
+  HypothesisSolver::LaneMask active = HypothesisSolver::LaneMask::Constant(false);
+  auto candidate_num = 0;
+  for (int id = 0; id < prediction_.armor_num; id++) {
+    for (int i = HALF_HORIZON + 1; i < HORIZON + 1 && !candidates[id]; i++)
+      candidates[id] = engageable(prediction_, id, i);
+    if (!candidates[id]) continue;
+
+    auto & traj = hypothesis_trajs_[id];
+    try {
+      HorizonIds ids;
+      ids.fill(id);
+      traj = aim_horizon(prediction_, ids, yaw0, bullet_speed);
+    } catch (const std::exception & e) {
+      candidates[id] = false;
+      continue;
+    }
+
+    auto yaw_lane = 2 * id + YAW_LANE;
+    auto pitch_lane = 2 * id + PITCH_LANE;
+    solver.set_x0(yaw_lane, traj.block<2, 1>(0, 0));
+    solver.set_x_ref(yaw_lane, traj.topRows<2>());
+    solver.set_x0(pitch_lane, traj.block<2, 1>(2, 0));
+    solver.set_x_ref(pitch_lane, traj.bottomRows<2>());
+    active(yaw_lane) = active(pitch_lane) = true;
+    candidate_num++;
+  }
+
+  if (candidate_num == 0) {
+    last_hypothesis_ = -1;
+    return std::nullopt;
+  }
+
+  // 2. 所有候选装甲板在同一个批量求解器中同时求解
+  auto time_ms = solve(solver, active);
+
+  // 3. 优先选择开火窗口最长的，窗口相同时选择代价最小的
+  // 上一次选择的装甲板代价打九折，避免两个装甲板代价接近时来回切换
+  auto shoot_offset = 2;
+  auto best_id = -1;
+  auto best_window = -1;
+  auto best_cost = 0.0;
+  for (int id = 0; id < prediction_.armor_num; id++) {
+    if (!candidates[id]) continue;
+
+    const auto & traj = hypothesis_trajs_[id];
+    const auto & yaw = solver.solution[2 * id + YAW_LANE];
+    const auto & pitch = solver.solution[2 * id + PITCH_LANE];
+
+    auto window = 0;
+    for (int i = HALF_HORIZON + shoot_offset; i < HORIZON; i++, window++) {
+      auto error = std::hypot(traj(0, i) - yaw.x(0, i), traj(2, i) - pitch.x(0, i));
+      if (error >= fire_thresh_ || !engageable(prediction_, id, i + 1)) break;
+    }
+
+    // 与MPC相同的目标函数
+    auto cost = 0.0;
+    for (auto [lane, row] : {std::pair{2 * id + YAW_LANE, 0}, std::pair{2 * id + PITCH_LANE, 2}}) {
+      const auto & solution = solver.solution[lane];
+      for (int j = 0; j < 2; j++)
+        cost += solver.work.Q(lane, j) * (solution.x.row(j) - traj.row(row + j)).squaredNorm();
+      cost += solver.work.R(lane, 0) * solution.u.squaredNorm();
+    }
+    if (id == last_hypothesis_) cost *= 0.9;
+
+    if (window > best_window || (window == best_window && cost < best_cost)) {
+      best_id = id;
+      best_window = window;
+      best_cost = cost;
+    }
+  }
+
+  last_hypothesis_ = best_id;
+  const auto & traj = hypothesis_trajs_[best_id];
+  const auto & yaw = solver.solution[2 * best_id + YAW_LANE];
+  const auto & pitch = solver.solution[2 * best_id + PITCH_LANE];
+  yaw_stats = {yaw.iter, yaw.solved, time_ms};
+  pitch_stats = {pitch.iter, pitch.solved, time_ms};
+
+  // 与aim一致，debug_xyza为所选装甲板在命中时刻的位置
+  aim_armor(prediction_, best_id, HALF_HORIZON + 1, bullet_speed);
+
+  return make_plan(traj, yaw0, yaw.x, yaw.u, pitch.x, pitch.u);
+}
+
+// 装甲板朝向与其方位角之差小于comming_angle时视为可击打，包括正在转入视野的装甲板
+bool Planner::engageable(const ArmorsPrediction & prediction, int id, int i) const
+{
+  auto azim = std::atan2(prediction.y(id, i), prediction.x(id, i));
+  return std::abs(tools::limit_rad(prediction.a(id, i) - azim)) < comming_angle_;
+}
+
+}  // namespace auto_aim
@@ -0,0 +1,224 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "planner.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/simd_math.hpp"
+#include "tools/tracer.hpp"
+#include "tools/trajectory.hpp"
+
+namespace auto_aim
+{
+Plan Planner::plan(const std::optional<TargetSnapshot> & target, double bullet_speed)
+{
+  if (!target.has_value()) return {false};
+
+  double delay_time =
+    std::abs(target->x[7]) > decision_speed_ ? high_speed_delay_time_ : low_speed_delay_time_;
+
+  auto future = std::chrono::steady_clock::now() + std::chrono::microseconds(int(delay_time * 1e6));
+
+  auto result = plan(target->predicted(future), bullet_speed);
+  result.frame_time = target->t;
+  return result;
+}
+
+Plan Planner::plan(const TargetSnapshot & target, double bullet_speed)
+{
+  TOOLS_TRACE_SPAN("planner.plan");
+
+  // 0. Check bullet speed
+  if (bullet_speed < 10 || bullet_speed > 25) {
+    bullet_speed = 22;
+  }
+
+  // 1. Predict fly_time
+  std::array<Eigen::Vector4d, MAX_ARMOR_NUM> xyza_list;
+  auto armor_num = target.armor_xyza_list(xyza_list);
+
+  Eigen::Vector3d xyz;
+  auto min_dist = 1e10;
+  for (int id = 0; id < armor_num; id++) {
+    auto dist = xyza_list[id].head<2>().norm();
+    if (dist < min_dist) {
+      min_dist = dist;
+      xyz = xyza_list[id].head<3>();
+    }
+  }
+  auto bullet_traj = tools::solve_trajectory(ballistic_table_, bullet_speed, min_dist, xyz.z());
+  auto future = target.predicted(bullet_traj.unsolvable ? 0.0 : bullet_traj.fly_time);
+
+  // 2. Get yaw0
+  double yaw0;
+  try {
+    future.predict_armors(0, 0, 1, prediction_);
+    yaw0 = aim(prediction_, 0, bullet_speed)(0);
+  } catch (const std::exception & e) {
+    tools::logger()->warn("Unsolvable target {:.2f}", bullet_speed);
+    return {false};
+  }
+
+  auto steps = shift_steps(std::chrono::steady_clock::now());
+  auto yaw0_offset = last_yaw0_.has_value() ? tools::limit_rad(*last_yaw0_ - yaw0) : 0.0;
+  last_yaw0_ = yaw0;
+
+  // 多假设规划，没有候选装甲板时退回到跟随最近装甲板
+  if (hypothesis_solver_) {
+    auto plan = plan_hypotheses(future, yaw0, steps, yaw0_offset, bullet_speed);
+    if (plan.has_value()) return *plan;
+  }
+
+  // 3. Get trajectory
+  Trajectory traj;
+  try {
+    traj = get_trajectory(future, yaw0, bullet_speed);
+  } catch (const std::exception & e) {
+    tools::logger()->warn("Unsolvable target {:.2f}", bullet_speed);
+    return {false};
+  }
+
+  auto & solver = *joint_solver_;
+  warm_start(solver, steps, yaw0_offset);
+
+  // 4. Solve yaw and pitch
+  solver.set_x0(YAW_LANE, traj.block<2, 1>(0, 0));
+  solver.set_x_ref(YAW_LANE, traj.topRows<2>());
+  solver.set_x0(PITCH_LANE, traj.block<2, 1>(2, 0));
+  solver.set_x_ref(PITCH_LANE, traj.bottomRows<2>());
+  auto time_ms = solve(solver);
+
+  const auto & yaw = solver.solution[YAW_LANE];
+  const auto & pitch = solver.solution[PITCH_LANE];
+  yaw_stats = {yaw.iter, yaw.solved, time_ms};
+  pitch_stats = {pitch.iter, pitch.solved, time_ms};
+  return make_plan(traj, yaw0, yaw.x, yaw.u, pitch.x, pitch.u);
+}
+
+Plan Planner::make_plan(
+  const Trajectory & traj, double yaw0, const StaticSolver::StateTrajectory & yaw_x,
+  const StaticSolver::InputTrajectory & yaw_u, const StaticSolver::StateTrajectory & pitch_x,
+  const StaticSolver::InputTrajectory & pitch_u) const
+{
+  Plan plan;
+  plan.control = true;
+
+  plan.target_yaw = tools::limit_rad(traj(0, HALF_HORIZON) + yaw0);
+  plan.target_pitch = traj(2, HALF_HORIZON);
+
+  plan.yaw = tools::limit_rad(yaw_x(0, HALF_HORIZON) + yaw0);
+  plan.yaw_vel = yaw_x(1, HALF_HORIZON);
+  plan.yaw_acc = yaw_u(0, HALF_HORIZON);
+
+  plan.pitch = pitch_x(0, HALF_HORIZON);
+  plan.pitch_vel = pitch_x(1, HALF_HORIZON);
+  plan.pitch_acc = pitch_u(0, HALF_HORIZON);
+
+  auto shoot_offset = 2;
+  plan.fire = std::hypot(
+                traj(0, HALF_HORIZON + shoot_offset) - yaw_x(0, HALF_HORIZON + shoot_offset),
+                traj(2, HALF_HORIZON + shoot_offset) - pitch_x(0, HALF_HORIZON + shoot_offset)) <
+              fire_thresh_;
+  return plan;
+}
+
+Eigen::Matrix<double, 2, 1> Planner::aim(
+  const ArmorsPrediction & prediction, int i, double bullet_speed)
+{
+  auto min_dist = 1e10;
+  int min_id = 0;
+  for (int id = 0; id < prediction.armor_num; id++) {
+    auto dist = std::hypot(prediction.x(id, i), prediction.y(id, i));
+    if (dist < min_dist) {
+      min_dist = dist;
+      min_id = id;
+    }
+  }
+
+  return aim_armor(prediction, min_id, i, bullet_speed);
+}
+
+Eigen::Matrix<double, 2, 1> Planner::aim_armor(
+  const ArmorsPrediction & prediction, int id, int i, double bullet_speed)
+{
+  Eigen::Vector3d xyz{prediction.x(id, i), prediction.y(id, i), prediction.z(id, i)};
+  debug_xyza = Eigen::Vector4d(xyz.x(), xyz.y(), xyz.z(), prediction.a(id, i));
+
+  auto azim = std::atan2(xyz.y(), xyz.x());
+  auto bullet_traj =
+    tools::solve_trajectory(ballistic_table_, bullet_speed, xyz.head<2>().norm(), xyz.z());
+  if (bullet_traj.unsolvable) throw std::runtime_error("Unsolvable bullet trajectory!");
+
+  return {tools::limit_rad(azim + yaw_offset_), -bullet_traj.pitch - pitch_offset_};
+}
+
+Trajectory Planner::get_trajectory(const TargetSnapshot & target, double yaw0, double bullet_speed)
+{
+  // 第0列对应-(HALF_HORIZON+1)*DT，额外两列用于中心差分求速度
+  target.predict_armors(-DT * (HALF_HORIZON + 1), DT, HORIZON + 2, prediction_);
+
+  // 与aim一致，每一步瞄准水平距离最近的装甲板
+  HorizonIds ids;
+  for (int i = 0; i < HORIZON + 2; i++) {
+    auto min_dist2 = 1e10;
+    ids[i] = 0;
+    for (int id = 0; id < prediction_.armor_num; id++) {
+      auto dist2 = prediction_.x(id, i) * prediction_.x(id, i) +
+                   prediction_.y(id, i) * prediction_.y(id, i);
+      if (dist2 < min_dist2) {
+        min_dist2 = dist2;
+        ids[i] = id;
+      }
+    }
+  }
+
+  return aim_horizon(prediction_, ids, yaw0, bullet_speed);
+}
+
+Trajectory Planner::aim_horizon(
+  const ArmorsPrediction & prediction, const HorizonIds & ids, double yaw0, double bullet_speed)
+{
+  constexpr int n = HORIZON + 2;
+  auto & b = horizon_;
+
+  // 1. 收集为SoA布局
+  for (int i = 0; i < n; i++) {
+    b.x[i] = prediction.x(ids[i], i);
+    b.y[i] = prediction.y(ids[i], i);
+    b.z[i] = prediction.z(ids[i], i);
+  }
+
+  // 2. 批量求方位角、水平距离和弹道，弹道不可解时为NaN
+  // 只需要yaw和水平距离，不调用xyz2ypd，省去仰角和斜距的计算
+  for (int i = 0; i < n; i++) {
+    b.yaw[i] = tools::simd_atan2(b.y[i], b.x[i]);
+    b.d[i] = std::sqrt(b.x[i] * b.x[i] + b.y[i] * b.y[i]);
+  }
+  tools::solve_trajectory(
+    ballistic_table_, bullet_speed, b.d.data(), b.z.data(), b.pitch.data(), b.fly_time.data(), n);
+
+  auto unsolvable = false;
+  for (int i = 0; i < n; i++) unsolvable |= std::isnan(b.pitch[i]);
+  if (unsolvable) throw std::runtime_error("Unsolvable bullet trajectory!");
+
+  // 与aim_armor一致，debug_xyza为最后一步的瞄准点
+  debug_xyza = {b.x[n - 1], b.y[n - 1], b.z[n - 1], prediction.a(ids[n - 1], n - 1)};
+
+  // 3. 加上补偿，yaw相对yaw0
+  for (int i = 0; i < n; i++) {
+    b.yaw[i] = tools::limit_rad(b.yaw[i] + yaw_offset_ - yaw0);
+    b.pitch[i] = -b.pitch[i] - pitch_offset_;
+  }
+
+  // 4. 中心差分求速度
+  Trajectory traj;
+  for (int i = 0; i < HORIZON; i++) {
+    auto yaw_vel = tools::limit_rad(b.yaw[i + 2] - b.yaw[i]) / (2 * DT);
+    auto pitch_vel = (b.pitch[i + 2] - b.pitch[i]) / (2 * DT);
+    traj.col(i) << b.yaw[i + 1], yaw_vel, b.pitch[i + 1], pitch_vel;
+  }
+
+  return traj;
+}
+
+}  // namespace auto_aim
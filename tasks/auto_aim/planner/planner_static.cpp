@@ -0,0 +1,109 @@
+#include <fmt/format.h>
+
+#include <filesystem>
+
+#include "planner.hpp"
+#include "tools/logger.hpp"
+#include "tools/yaml.hpp"
+
+namespace auto_aim
+{
+namespace
+{
+// 按参数哈希缓存到cache_dir下，参数不变时直接读取
+std::shared_ptr<const RhoBank> load_rho_bank(
+  const std::string & cache_dir, const YAML::Node & yaml, const std::string & axis)
+{
+  auto Q_dig = tools::read<std::vector<double>>(yaml, "Q_" + axis);
+  auto R_dig = tools::read<std::vector<double>>(yaml, "R_" + axis);
+
+  StaticSolver::StateMatrix A{{1, DT}, {0, 1}};
+  StaticSolver::InputMatrix B{0, DT};
+  StaticSolver::StateVector f{0, 0};
+  StaticSolver::StateVector Q(Q_dig.data());
+  StaticSolver::InputVector R(R_dig.data());
+  auto hash = RhoBank::params_hash(A, B, f, Q, R, {});
+  auto path = fmt::format("{}/rho_{:016x}.bin", cache_dir, hash);
+
+  std::shared_ptr<const RhoBank> bank = RhoBank::load(path, A, B, f, Q, R);
+  if (bank) return bank;
+
+  bank = std::make_shared<const RhoBank>(A, B, f, Q, R);
+  std::error_code ec;
+  std::filesystem::create_directories(cache_dir, ec);
+  if (!bank->save(path)) tools::logger()->warn("[Planner] Failed to save {}", path);
+  return bank;
+}
+}  // namespace
+
+void Planner::setup_static_solvers(const std::string & config_path)
+{
+  auto yaml = tools::load(config_path);
+  ballistic_table_ = tools::BallisticTable::from_config(config_path);
+
+  // yaw和pitch的模型相同：状态为角度和角速度，输入为角加速度，只有输入约束
+  // 优先使用代码生成的缓存，未命中时在启动时计算，结果与tiny_setup一致
+  auto rho = tools::read<double>(yaml, "mpc_rho");
+  auto setup = [&](const std::string & axis, StaticSolver & problem) {
+    auto max_acc = tools::read<double>(yaml, "max_" + axis + "_acc");
+    auto Q = tools::read<std::vector<double>>(yaml, "Q_" + axis);
+    auto R = tools::read<std::vector<double>>(yaml, "R_" + axis);
+    auto data = find_static_solver(solver_hash(DT, HORIZON, max_acc, Q, R, rho));
+    if (data) {
+      setup_static_solver(problem, *data, DT);
+      return data;
+    }
+
+    StaticSolver::StateMatrix A{{1, DT}, {0, 1}};
+    StaticSolver::InputMatrix B{0, DT};
+    StaticSolver::StateVector f{0, 0};
+    StaticSolver::StateVector Q_dig(Q.data());
+    StaticSolver::InputVector R_dig(R.data());
+    problem.setup(A, B, f, Q_dig, R_dig, rho);
+    problem.set_input_bound(
+      StaticSolver::InputTrajectory::Constant(-max_acc),
+      StaticSolver::InputTrajectory::Constant(max_acc));
+    return data;
+  };
+
+  StaticSolver yaw_problem, pitch_problem;
+  auto yaw_data = setup("yaw", yaw_problem);
+  auto pitch_data = setup("pitch", pitch_problem);
+  if (!yaw_data || !pitch_data)
+    tools::logger()->info(
+      "[Planner] No generated solver matches {}, caches computed at startup; run planner_codegen "
+      "to regenerate static_solver_data.hpp",
+      config_path);
+
+  // 所有通道共用终止条件，收敛阈值与tinympc的默认值一致
+  auto max_iter = tools::read<int>(yaml, "mpc_max_iter");
+
+  joint_solver_ = std::make_unique<JointSolver>();
+  joint_solver_->setup(YAW_LANE, yaw_problem);
+  joint_solver_->setup(PITCH_LANE, pitch_problem);
+  joint_solver_->settings.max_iter = max_iter;
+
+  // 未配置multi_hypothesis时不启用
+  if (yaml["multi_hypothesis"] && yaml["multi_hypothesis"].as<bool>()) {
+    comming_angle_ = tools::read<double>(yaml, "comming_angle") / 57.3;  // degree to rad
+    hypothesis_solver_ = std::make_unique<HypothesisSolver>();
+    for (int id = 0; id < MAX_ARMOR_NUM; id++) {
+      hypothesis_solver_->setup(2 * id + YAW_LANE, yaw_problem);
+      hypothesis_solver_->setup(2 * id + PITCH_LANE, pitch_problem);
+    }
+    hypothesis_solver_->settings.max_iter = max_iter;
+  }
+
+  // 未配置adaptive_rho时不启用
+  if (yaml["adaptive_rho"] && yaml["adaptive_rho"].as<bool>()) {
+    auto cache_dir = tools::read<std::string>(yaml, "rho_cache");
+    rho_banks_[YAW_LANE] = load_rho_bank(cache_dir, yaml, "yaw");
+    rho_banks_[PITCH_LANE] = load_rho_bank(cache_dir, yaml, "pitch");
+    tools::logger()->info(
+      "[Planner] Adaptive rho on {} cached values", rho_banks_[YAW_LANE]->size());
+  }
+
+  tools::logger()->info("[Planner] Using fixed-size solvers for {}", config_path);
+}
+
+}  // namespace auto_aim
@@ -0,0 +1,125 @@
+#include <algorithm>
+
+#include "planner.hpp"
+#include "tools/tracer.hpp"
+
+namespace auto_aim
+{
+namespace
+{
+// 将轨迹整体左移steps步，末尾用最后一步补齐，每一步占stride列
+template <typename Derived>
+void shift_columns(Eigen::DenseBase<Derived> & m, int steps, int stride = 1)
+{
+  auto n = static_cast<int>(m.cols()) / stride;
+  if (steps <= 0 || n == 0) return;
+
+  if (steps >= n) {
+    m = m.rightCols(stride).replicate(1, n).eval();
+    return;
+  }
+
+  auto keep = (n - steps) * stride;
+  m.leftCols(keep) = m.rightCols(keep).eval();
+  m.rightCols(steps * stride) = m.middleCols(keep - stride, stride).replicate(1, steps).eval();
+}
+
+// 批量求解器按yaw、pitch交替排列通道，yaw零点变化时平移所有yaw通道
+template <typename Solver>
+void shift_lanes(Solver & solver, int steps, double yaw0_offset)
+{
+  auto & work = solver.work;
+
+  // 每一步占连续的NX（或NU）列；未启用状态约束，vnew即为x，g恒为0
+  for (auto m : {&work.x, &work.v}) shift_columns(*m, steps, 2);
+  for (auto m : {&work.u, &work.z, &work.znew, &work.y, &work.d}) shift_columns(*m, steps, 1);
+
+  if (yaw0_offset == 0) return;
+  for (auto m : {&work.x, &work.v})
+    for (int lane = YAW_LANE; lane < Solver::lanes; lane += 2)
+      for (int i = 0; i < HORIZON; i++) (*m)(lane, i * 2) += yaw0_offset;
+}
+
+// 按残差平衡在缓存库中切换各通道的rho，通道按yaw、pitch交替排列
+// 已收敛的通道不再切换；所有通道的缓存替换完后只做一次反向传播
+template <typename Solver>
+void adapt_rho(Solver & solver, const RhoBanks & banks)
+{
+  const auto & work = solver.work;
+  auto changed = false;
+  for (int lane = 0; lane < Solver::lanes; lane++) {
+    const auto & bank = banks[lane % 2];
+    if (!bank || solver.done()(lane)) continue;
+
+    auto primal = std::max(work.primal_residual_state(lane), work.primal_residual_input(lane));
+    auto dual = std::max(work.dual_residual_state(lane), work.dual_residual_input(lane));
+    auto i = bank->select(solver.cache.rho(lane), primal, dual, RHO_TOLERANCE);
+    if (i < 0) continue;
+
+    solver.load_cache(lane, bank->at(i));
+    changed = true;
+  }
+  if (changed) solver.refresh();
+}
+
+// 分段迭代，超出时间预算时提前结束，返回耗时(ms)
+// 只迭代到active中的通道收敛为止，其余通道不参与终止判断
+template <typename Solver>
+double solve_lanes(
+  Solver & solver, const RhoBanks & banks, const typename Solver::LaneMask & active)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto max_iter = solver.settings.max_iter;
+
+  solver.begin(active);
+  for (int iter = 0; iter < max_iter; iter += SOLVE_CHUNK_ITER) {
+    if (solver.iterate(std::min(SOLVE_CHUNK_ITER, max_iter - iter))) break;
+    adapt_rho(solver, banks);
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (elapsed > SOLVE_BUDGET) break;
+  }
+  solver.end();
+
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+}  // namespace
+
+int Planner::shift_steps(std::chrono::steady_clock::time_point t)
+{
+  if (!last_shift_time_.has_value()) {
+    last_shift_time_ = t;
+    return 0;
+  }
+
+  // 只按整数个DT平移，余数留到下一次规划，避免4ms的规划周期被取整成0或DT
+  auto elapsed = std::chrono::duration<double>(t - *last_shift_time_).count();
+  auto steps = static_cast<int>(elapsed / DT);
+  *last_shift_time_ += std::chrono::microseconds(static_cast<int64_t>(steps * DT * 1e6));
+  return steps;
+}
+
+void Planner::warm_start(JointSolver & solver, int steps, double yaw0_offset)
+{
+  shift_lanes(solver, steps, yaw0_offset);
+}
+
+void Planner::warm_start(HypothesisSolver & solver, int steps, double yaw0_offset)
+{
+  shift_lanes(solver, steps, yaw0_offset);
+}
+
+double Planner::solve(JointSolver & solver)
+{
+  TOOLS_TRACE_SPAN("planner.solve");
+  return solve_lanes(solver, rho_banks_, JointSolver::LaneMask::Constant(true));
+}
+
+double Planner::solve(HypothesisSolver & solver, const HypothesisSolver::LaneMask & active)
+{
+  TOOLS_TRACE_SPAN("planner.solve");
+  return solve_lanes(solver, rho_banks_, active);
+}
+
+}  // namespace auto_aim
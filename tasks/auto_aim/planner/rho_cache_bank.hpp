@@ -0,0 +1,208 @@
+#ifndef AUTO_AIM__RHO_CACHE_BANK_HPP
+#define AUTO_AIM__RHO_CACHE_BANK_HPP
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tiny_solver.hpp"
+
+namespace tinympc
+{
+struct RhoGrid
+{
+  double rho_min = 1e-2;
+  double rho_max = 1e3;
+  int per_decade = 8;  // 每十倍的网格点数
+};
+
+// 对数等间隔的rho网格上预先计算的TinyMPC缓存，替代adaptive_rho的一阶灵敏度更新
+// 每个网格点都是完整的Riccati解，调整rho只是切换到另一个网格点，不做Riccati迭代
+// 网格点之间按log(rho)线性插值，插值结果只是近似的Riccati解
+template <typename Problem>
+class RhoCacheBank
+{
+public:
+  using Cache = typename Problem::Cache;
+
+  RhoCacheBank(
+    const typename Problem::StateMatrix & A, const typename Problem::InputMatrix & B,
+    const typename Problem::StateVector & f, const typename Problem::StateVector & Q_dig,
+    const typename Problem::InputVector & R_dig, const RhoGrid & grid = {})
+  : RhoCacheBank(A, B, f, Q_dig, R_dig, grid, false)
+  {
+    for (int i = 0; i < size(); i++)
+      caches_[i] = Problem::compute_cache(A, B, f, Q_dig, R_dig, rho(i));
+  }
+
+  // 参数（含网格）与保存时一致才会读取成功，否则返回nullptr
+  static std::unique_ptr<const RhoCacheBank> load(
+    const std::string & path, const typename Problem::StateMatrix & A,
+    const typename Problem::InputMatrix & B, const typename Problem::StateVector & f,
+    const typename Problem::StateVector & Q_dig, const typename Problem::InputVector & R_dig,
+    const RhoGrid & grid = {})
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return nullptr;
+
+    std::unique_ptr<RhoCacheBank> bank(new RhoCacheBank(A, B, f, Q_dig, R_dig, grid, true));
+    FileHeader header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (
+      !file || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+      header.hash != bank->hash_ || header.size != bank->size())
+      return nullptr;
+
+    auto read = [&](int n, double * data) {
+      file.read(reinterpret_cast<char *>(data), n * sizeof(double));
+    };
+    for (auto & cache : bank->caches_) for_each_field(read, cache);
+    if (!file) return nullptr;
+
+    return bank;
+  }
+
+  bool save(const std::string & path) const
+  {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.hash = hash_;
+    header.size = size();
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    auto write = [&](int n, const double * data) {
+      file.write(reinterpret_cast<const char *>(data), n * sizeof(double));
+    };
+    for (const auto & cache : caches_) for_each_field(write, cache);
+    return bool(file);
+  }
+
+  int size() const { return static_cast<int>(caches_.size()); }
+  uint64_t hash() const { return hash_; }
+  double rho(int i) const { return grid_.rho_min * std::pow(10.0, double(i) / grid_.per_decade); }
+  const Cache & at(int i) const { return caches_[i]; }
+
+  // 最近的网格点，O(1)
+  int index(double rho) const
+  {
+    auto i = std::lround(std::log10(rho / grid_.rho_min) * grid_.per_decade);
+    return std::clamp<int>(i, 0, size() - 1);
+  }
+
+  // 网格范围外取端点
+  Cache lookup(double rho) const
+  {
+    auto fi = std::clamp(std::log10(rho / grid_.rho_min) * grid_.per_decade, 0.0, size() - 1.0);
+    auto i = std::min(static_cast<int>(fi), size() - 2);
+    auto w = fi - i;
+
+    Cache result = caches_[i];
+    auto lerp = [w](int n, double * a, const double * b) {
+      for (int j = 0; j < n; j++) a[j] += w * (b[j] - a[j]);
+    };
+    for_each_field(lerp, result, caches_[i + 1]);
+    result.rho = std::clamp(rho, grid_.rho_min, this->rho(size() - 1));
+    return result;
+  }
+
+  // 残差平衡：原始残差与对偶残差相差超过tolerance倍时，切换到rho * sqrt(原始残差 / 对偶残差)
+  // 最近的网格点；返回-1表示不需要切换
+  int select(double rho, double primal_residual, double dual_residual, double tolerance) const
+  {
+    if (primal_residual <= 0 || dual_residual <= 0) return -1;
+
+    auto ratio = primal_residual / dual_residual;
+    if (ratio < tolerance && ratio > 1 / tolerance) return -1;
+
+    auto i = index(rho * std::sqrt(ratio));
+    return i == index(rho) ? -1 : i;
+  }
+
+  // 由全部参数计算的FNV-1a哈希，可用作缓存文件名
+  static uint64_t params_hash(
+    const typename Problem::StateMatrix & A, const typename Problem::InputMatrix & B,
+    const typename Problem::StateVector & f, const typename Problem::StateVector & Q_dig,
+    const typename Problem::InputVector & R_dig, const RhoGrid & grid)
+  {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&](double value) {
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      for (int i = 0; i < 8; i++) {
+        hash ^= (bits >> (8 * i)) & 0xff;
+        hash *= 0x100000001b3ULL;
+      }
+    };
+    auto mix_matrix = [&](const auto & m) {
+      for (int i = 0; i < m.size(); i++) mix(m.data()[i]);
+    };
+    mix(VERSION);
+    mix_matrix(A);
+    mix_matrix(B);
+    mix_matrix(f);
+    mix_matrix(Q_dig);
+    mix_matrix(R_dig);
+    mix(grid.rho_min);
+    mix(grid.rho_max);
+    mix(grid.per_decade);
+    return hash;
+  }
+
+private:
+  static constexpr char MAGIC[4] = {'R', 'H', 'O', 'B'};
+  static constexpr uint32_t VERSION = 1;  // 修改缓存的计算方法或文件布局时递增，使旧文件失效
+
+  struct FileHeader
+  {
+    char magic[4];
+    uint32_t version;
+    uint64_t hash;
+    int32_t size;
+  };
+
+  static constexpr int NX = Problem::StateVector::RowsAtCompileTime;
+  static constexpr int NU = Problem::InputVector::RowsAtCompileTime;
+  static constexpr int NX_NX = NX * NX, NU_NX = NU * NX, NU_NU = NU * NU;
+
+  RhoGrid grid_;
+  uint64_t hash_;
+  std::vector<Cache> caches_;
+
+  RhoCacheBank(
+    const typename Problem::StateMatrix & A, const typename Problem::InputMatrix & B,
+    const typename Problem::StateVector & f, const typename Problem::StateVector & Q_dig,
+    const typename Problem::InputVector & R_dig, const RhoGrid & grid, bool)
+  : grid_(grid),
+    hash_(params_hash(A, B, f, Q_dig, R_dig, grid)),
+    caches_(std::lround(std::log10(grid.rho_max / grid.rho_min) * grid.per_decade) + 1)
+  {
+  }
+
+  // 按固定顺序同时遍历一个或多个缓存中的各个矩阵，f(元素个数, 各缓存中该矩阵的数据指针...)
+  template <typename F, typename... Caches>
+  static void for_each_field(F && f, Caches &... caches)
+  {
+    f(1, &caches.rho...);
+    f(NU_NX, caches.Kinf.data()...);
+    f(NX_NX, caches.Pinf.data()...);
+    f(NU_NU, caches.Quu_inv.data()...);
+    f(NX_NX, caches.AmBKt.data()...);
+    f(NX, caches.APf.data()...);
+    f(NU, caches.BPf.data()...);
+  }
+
+};
+
+}  // namespace tinympc
+
+#endif  // AUTO_AIM__RHO_CACHE_BANK_HPP
@@ -0,0 +1,100 @@
+#include "static_solver.hpp"
+
+#include <fmt/format.h>
+
+#include <cstring>
+
+#include "static_solver_data.hpp"
+
+namespace auto_aim
+{
+namespace
+{
+// FNV-1a
+uint64_t hash_bytes(uint64_t hash, const void * data, std::size_t size)
+{
+  auto bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+uint64_t hash_double(uint64_t hash, double value)
+{
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return hash_bytes(hash, &bits, sizeof(bits));
+}
+
+std::string join(const double * values, int n)
+{
+  std::string str;
+  for (int i = 0; i < n; i++) str += fmt::format("{}{:.17g}", i ? ", " : "", values[i]);
+  return str;
+}
+}  // namespace
+
+uint64_t solver_hash(
+  double dt, int horizon, double max_acc, const std::vector<double> & Q,
+  const std::vector<double> & R, double rho)
+{
+  uint64_t hash = 14695981039346656037ull;
+  hash = hash_double(hash, dt);
+  hash = hash_bytes(hash, &horizon, sizeof(horizon));
+  hash = hash_double(hash, max_acc);
+  for (auto q : Q) hash = hash_double(hash, q);
+  for (auto r : R) hash = hash_double(hash, r);
+  return hash_double(hash, rho);
+}
+
+const StaticSolverData * find_static_solver(uint64_t hash)
+{
+  for (const auto & data : generated::STATIC_SOLVERS)
+    if (data.hash == hash) return &data;
+  return nullptr;
+}
+
+void setup_static_solver(StaticSolver & solver, const StaticSolverData & data, double dt)
+{
+  using RowMajor2d = Eigen::Matrix<double, 2, 2, Eigen::RowMajor>;
+
+  StaticSolver::Cache cache;
+  cache.rho = data.rho;
+  cache.Kinf = Eigen::Map<const Eigen::Matrix<double, 1, 2>>(data.Kinf);
+  cache.Pinf = Eigen::Map<const RowMajor2d>(data.Pinf);
+  cache.Quu_inv(0, 0) = data.Quu_inv[0];
+  cache.AmBKt = Eigen::Map<const RowMajor2d>(data.AmBKt);
+  cache.APf = Eigen::Map<const Eigen::Vector2d>(data.APf);
+  cache.BPf(0) = data.BPf[0];
+
+  Eigen::Matrix2d A{{1, dt}, {0, 1}};
+  Eigen::Vector2d B{0, dt};
+  Eigen::Vector2d f{0, 0};
+  Eigen::Vector2d Q(data.Q);
+  Eigen::Matrix<double, 1, 1> R(data.R);
+  solver.setup(A, B, f, Q, R, cache);
+
+  solver.set_input_bound(
+    StaticSolver::InputTrajectory::Constant(-data.max_acc),
+    StaticSolver::InputTrajectory::Constant(data.max_acc));
+}
+
+std::string to_source(const StaticSolverData & data, const std::string & comment)
+{
+  return fmt::format(
+    "  // {}\n"
+    "  {{0x{:016x}ull, {:.17g}, {{{}}}, {{{}}}, {:.17g},\n"
+    "   {{{}}},\n"
+    "   {{{}}},\n"
+    "   {{{}}},\n"
+    "   {{{}}},\n"
+    "   {{{}}},\n"
+    "   {{{}}}}},\n",
+    comment, data.hash, data.max_acc, join(data.Q, 2), join(data.R, 1), data.rho,
+    join(data.Kinf, 2), join(data.Pinf, 4), join(data.Quu_inv, 1), join(data.AmBKt, 4),
+    join(data.APf, 2), join(data.BPf, 1));
+}
+
+}  // namespace auto_aim
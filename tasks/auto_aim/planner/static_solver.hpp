@@ -0,0 +1,48 @@
+#ifndef AUTO_AIM__STATIC_SOLVER_HPP
+#define AUTO_AIM__STATIC_SOLVER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tiny_solver.hpp"
+
+namespace auto_aim
+{
+// 与Planner中yaw/pitch求解器相同的维度：状态为角度和角速度，输入为角加速度
+constexpr int STATIC_SOLVER_HORIZON = 100;
+using StaticSolver = tinympc::TinySolver<2, 1, STATIC_SOLVER_HORIZON>;
+
+// 代码生成的求解器数据，矩阵均按行优先存储
+struct StaticSolverData
+{
+  uint64_t hash;
+  double max_acc;
+  double Q[2];
+  double R[1];
+  double rho;
+  double Kinf[2];
+  double Pinf[4];
+  double Quu_inv[1];
+  double AmBKt[4];
+  double APf[2];
+  double BPf[1];
+};
+
+// 由单轴求解器的全部参数计算哈希，参数与代码生成时一致才会命中
+uint64_t solver_hash(
+  double dt, int horizon, double max_acc, const std::vector<double> & Q,
+  const std::vector<double> & R, double rho);
+
+// 在代码生成的数据中查找，未命中返回nullptr
+const StaticSolverData * find_static_solver(uint64_t hash);
+
+// 用代码生成的缓存初始化定长求解器，不做Riccati迭代和堆内存分配
+void setup_static_solver(StaticSolver & solver, const StaticSolverData & data, double dt);
+
+// 将求解器参数和缓存写成StaticSolverData的初始化列表，供代码生成使用
+std::string to_source(const StaticSolverData & data, const std::string & comment);
+
+}  // namespace auto_aim
+
+#endif  // AUTO_AIM__STATIC_SOLVER_HPP
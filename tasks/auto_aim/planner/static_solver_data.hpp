@@ -0,0 +1,39 @@
+// 由src/planner_codegen.cpp生成，请勿手动修改
+#ifndef AUTO_AIM__STATIC_SOLVER_DATA_HPP
+#define AUTO_AIM__STATIC_SOLVER_DATA_HPP
+
+#include "static_solver.hpp"
+
+namespace auto_aim::generated
+{
+// hash, max_acc, Q, R, rho, Kinf, Pinf, Quu_inv, AmBKt, APf, BPf
+constexpr StaticSolverData STATIC_SOLVERS[] = {
+  // configs/standard3.yaml yaw, configs/standard3.yaml pitch
+  {0x1aa9579245ceb4cbull, 50, {9000000, 0}, {10}, 1,
+   {702.79925934396726, 41.171086563594741},
+   {52723420.952616185, 1280593.3007389226, 1280593.3007389228, 62213.236883702906},
+   {0.054880754938690171},
+   {1, -7.0279925934396728, 0.01, 0.58828913436405261},
+   {0, 0},
+   {0}},
+  // configs/standard4.yaml yaw, configs/demo.yaml yaw
+  {0x7e9dad0c4553ef76ull, 50, {9000000, 0}, {1}, 1,
+   {1287.7726148412398, 57.599127926082211},
+   {40254953.481027901, 698881.29926265101, 698881.29926265101, 24270.551370451169},
+   {0.18426199379733454},
+   {1, -12.877726148412398, 0.01, 0.42400872073917784},
+   {0, 0},
+   {0}},
+  // configs/standard4.yaml pitch, configs/demo.yaml pitch
+  {0xe5592dfefaa34a26ull, 100, {9000000, 0}, {1}, 1,
+   {1287.7726148412398, 57.599127926082211},
+   {40254953.481027901, 698881.29926265101, 698881.29926265101, 24270.551370451169},
+   {0.18426199379733454},
+   {1, -12.877726148412398, 0.01, 0.42400872073917784},
+   {0, 0},
+   {0}},
+};
+
+}  // namespace auto_aim::generated
+
+#endif  // AUTO_AIM__STATIC_SOLVER_DATA_HPP
@@ -0,0 +1,312 @@
+#ifndef AUTO_AIM__TINY_SOLVER_HPP
+#define AUTO_AIM__TINY_SOLVER_HPP
+
+#include <Eigen/Dense>
+#include <type_traits>
+
+namespace tinympc
+{
+// 编译期选择的约束类型
+enum Constraint : unsigned
+{
+  NO_CONSTRAINT = 0,
+  STATE_BOUND = 1 << 0,
+  INPUT_BOUND = 1 << 1,
+};
+
+namespace detail
+{
+struct Empty
+{
+};
+
+// 未启用的约束不占用存储
+template <bool Enabled, typename T>
+using Optional = std::conditional_t<Enabled, T, Empty>;
+}  // namespace detail
+
+// 固定维度的TinyMPC求解器，算法与tinympc/admm一致
+// 所有工作区为定长Eigen矩阵，不做堆内存分配；未启用的约束对应的松弛/对偶变量及其每次迭代的更新在编译期去除
+// 不支持锥约束和线性约束
+template <int NX, int NU, int N, unsigned Constraints = INPUT_BOUND>
+class TinySolver
+{
+public:
+  static constexpr bool en_state_bound = Constraints & STATE_BOUND;
+  static constexpr bool en_input_bound = Constraints & INPUT_BOUND;
+
+  using StateMatrix = Eigen::Matrix<double, NX, NX>;
+  using InputMatrix = Eigen::Matrix<double, NX, NU>;
+  using StateVector = Eigen::Matrix<double, NX, 1>;
+  using InputVector = Eigen::Matrix<double, NU, 1>;
+  using StateTrajectory = Eigen::Matrix<double, NX, N>;
+  using InputTrajectory = Eigen::Matrix<double, NU, N - 1>;
+
+  struct Settings
+  {
+    double abs_pri_tol = 1e-3;
+    double abs_dua_tol = 1e-3;
+    int max_iter = 1000;
+    int check_termination = 1;
+  };
+
+  struct Cache
+  {
+    double rho;
+    Eigen::Matrix<double, NU, NX> Kinf;
+    StateMatrix Pinf;
+    Eigen::Matrix<double, NU, NU> Quu_inv;
+    StateMatrix AmBKt;
+    StateVector APf;
+    InputVector BPf;
+  };
+
+  struct Workspace
+  {
+    StateTrajectory x, q, p;
+    InputTrajectory u, r, d;
+
+    // 输入约束的松弛变量和对偶变量
+    InputTrajectory z, znew, y;
+
+    // 状态约束的松弛变量和对偶变量
+    // 不启用状态约束时vnew恒等于x、g恒为0，只保留上一次的x用于计算对偶残差
+    StateTrajectory v;
+    detail::Optional<en_state_bound, StateTrajectory> vnew, g;
+
+    StateTrajectory Xref;
+    InputTrajectory Uref;
+
+    detail::Optional<en_state_bound, StateTrajectory> x_min, x_max;
+    detail::Optional<en_input_bound, InputTrajectory> u_min, u_max;
+
+    StateVector Q;
+    InputVector R;
+    StateMatrix Adyn;
+    InputMatrix Bdyn;
+    StateVector fdyn;
+
+    double primal_residual_state, primal_residual_input;
+    double dual_residual_state, dual_residual_input;
+    int iter;
+  };
+
+  Settings settings;
+  Cache cache;
+  Workspace work;
+
+  TinySolver() = default;
+
+  void setup(
+    const StateMatrix & A, const InputMatrix & B, const StateVector & f, const StateVector & Q_dig,
+    const InputVector & R_dig, double rho)
+  {
+    reset(A, B, f, Q_dig, R_dig, rho);
+    cache = compute_cache(A, B, f, Q_dig, R_dig, rho);
+  }
+
+  // 使用预先计算的缓存（如代码生成的数据），跳过Riccati迭代
+  void setup(
+    const StateMatrix & A, const InputMatrix & B, const StateVector & f, const StateVector & Q_dig,
+    const InputVector & R_dig, const Cache & cache)
+  {
+    reset(A, B, f, Q_dig, R_dig, cache.rho);
+    this->cache = cache;
+  }
+
+  // 与tiny_setup一致：缓存由已加rho的Q、R再加一次rho计算得到
+  static Cache compute_cache(
+    const StateMatrix & A, const InputMatrix & B, const StateVector & f, const StateVector & Q_dig,
+    const InputVector & R_dig, double rho)
+  {
+    StateMatrix Q1 = (Q_dig.array() + rho).matrix().asDiagonal();
+    Q1 += rho * StateMatrix::Identity();
+    Eigen::Matrix<double, NU, NU> R1 = (R_dig.array() + rho).matrix().asDiagonal();
+    R1 += rho * Eigen::Matrix<double, NU, NU>::Identity();
+
+    Eigen::Matrix<double, NU, NX> Ktp1 = Eigen::Matrix<double, NU, NX>::Zero();
+    StateMatrix Ptp1 = rho * StateMatrix::Identity();
+    Eigen::Matrix<double, NU, NX> Kinf;
+    StateMatrix Pinf;
+
+    for (int i = 0; i < 1000; i++) {
+      Kinf = (R1 + B.transpose() * Ptp1 * B).inverse() * B.transpose() * Ptp1 * A;
+      Pinf = Q1 + A.transpose() * Ptp1 * (A - B * Kinf);
+      // rho很小时第一次迭代的Kinf本身可能小于阈值，至少迭代两次
+      if (i > 0 && (Kinf - Ktp1).cwiseAbs().maxCoeff() < 1e-5) break;
+      Ktp1 = Kinf;
+      Ptp1 = Pinf;
+    }
+
+    Cache cache;
+    cache.rho = rho;
+    cache.Kinf = Kinf;
+    cache.Pinf = Pinf;
+    cache.Quu_inv = (R1 + B.transpose() * Pinf * B).inverse();
+    cache.AmBKt = (A - B * Kinf).transpose();
+    cache.APf = cache.AmBKt * Pinf * f;
+    cache.BPf = B.transpose() * Pinf * f;
+    return cache;
+  }
+
+  // 切换到另一个rho的缓存（如RhoCacheBank中的），迭代中途也可调用
+  // Q、R中的rho随之更新，缩放对偶变量按新旧rho之比换算，再重新计算反向传播使下一次迭代使用新缓存
+  void set_cache(const Cache & cache)
+  {
+    auto scale = this->cache.rho / cache.rho;
+    work.Q.array() += cache.rho - this->cache.rho;
+    work.R.array() += cache.rho - this->cache.rho;
+    work.y *= scale;
+    if constexpr (en_state_bound) work.g *= scale;
+    this->cache = cache;
+
+    update_linear_cost();
+    backward_pass_grad();
+  }
+
+  template <bool Enabled = en_state_bound, typename = std::enable_if_t<Enabled>>
+  void set_state_bound(const StateTrajectory & x_min, const StateTrajectory & x_max)
+  {
+    work.x_min = x_min;
+    work.x_max = x_max;
+  }
+
+  template <bool Enabled = en_input_bound, typename = std::enable_if_t<Enabled>>
+  void set_input_bound(const InputTrajectory & u_min, const InputTrajectory & u_max)
+  {
+    work.u_min = u_min;
+    work.u_max = u_max;
+  }
+
+  void set_x0(const StateVector & x0) { work.x.col(0) = x0; }
+
+  // 返回0表示收敛
+  int solve()
+  {
+    work.iter = 0;
+    for (int i = 0; i < settings.max_iter; i++) {
+      forward_pass();
+      update_slack();
+      update_dual();
+      update_linear_cost();
+      work.iter++;
+
+      if (termination_condition()) return 0;
+
+      work.v = state_slack();
+      work.z = work.znew;
+      backward_pass_grad();
+    }
+    return 1;
+  }
+
+  // 状态轨迹的松弛变量，不启用状态约束时即为x
+  const StateTrajectory & state_slack() const
+  {
+    if constexpr (en_state_bound)
+      return work.vnew;
+    else
+      return work.x;
+  }
+
+private:
+  void reset(
+    const StateMatrix & A, const InputMatrix & B, const StateVector & f, const StateVector & Q_dig,
+    const InputVector & R_dig, double rho)
+  {
+    work.x.setZero();
+    work.q.setZero();
+    work.p.setZero();
+    work.u.setZero();
+    work.r.setZero();
+    work.d.setZero();
+    work.z.setZero();
+    work.znew.setZero();
+    work.y.setZero();
+    work.v.setZero();
+    if constexpr (en_state_bound) {
+      work.vnew.setZero();
+      work.g.setZero();
+    }
+    work.Xref.setZero();
+    work.Uref.setZero();
+
+    work.Q = Q_dig.array() + rho;
+    work.R = R_dig.array() + rho;
+    work.Adyn = A;
+    work.Bdyn = B;
+    work.fdyn = f;
+  }
+
+  void backward_pass_grad()
+  {
+    for (int i = N - 2; i >= 0; i--) {
+      work.d.col(i).noalias() =
+        cache.Quu_inv * (work.Bdyn.transpose() * work.p.col(i + 1) + work.r.col(i) + cache.BPf);
+      work.p.col(i).noalias() = work.q.col(i) + cache.AmBKt.lazyProduct(work.p.col(i + 1)) -
+                                cache.Kinf.transpose().lazyProduct(work.r.col(i)) + cache.APf;
+    }
+  }
+
+  void forward_pass()
+  {
+    for (int i = 0; i < N - 1; i++) {
+      work.u.col(i).noalias() = -cache.Kinf.lazyProduct(work.x.col(i)) - work.d.col(i);
+      work.x.col(i + 1).noalias() = work.Adyn.lazyProduct(work.x.col(i)) +
+                                    work.Bdyn.lazyProduct(work.u.col(i)) + work.fdyn;
+    }
+  }
+
+  void update_slack()
+  {
+    work.znew = work.u + work.y;
+    if constexpr (en_input_bound) work.znew = work.u_max.cwiseMin(work.u_min.cwiseMax(work.znew));
+
+    if constexpr (en_state_bound) {
+      work.vnew = work.x + work.g;
+      work.vnew = work.x_max.cwiseMin(work.x_min.cwiseMax(work.vnew));
+    }
+  }
+
+  void update_dual()
+  {
+    work.y += work.u - work.znew;
+    if constexpr (en_state_bound) work.g += work.x - work.vnew;
+  }
+
+  void update_linear_cost()
+  {
+    work.r = -(work.Uref.array().colwise() * work.R.array());
+    work.r.noalias() -= cache.rho * (work.znew - work.y);
+
+    work.q = -(work.Xref.array().colwise() * work.Q.array());
+    if constexpr (en_state_bound)
+      work.q.noalias() -= cache.rho * (work.vnew - work.g);
+    else
+      work.q.noalias() -= cache.rho * work.x;
+
+    work.p.col(N - 1) = -(work.Xref.col(N - 1).transpose().lazyProduct(cache.Pinf)).transpose();
+    work.p.col(N - 1).noalias() -= cache.rho * state_slack().col(N - 1);
+    if constexpr (en_state_bound) work.p.col(N - 1).noalias() += cache.rho * work.g.col(N - 1);
+  }
+
+  bool termination_condition()
+  {
+    if (work.iter % settings.check_termination != 0) return false;
+
+    work.primal_residual_state =
+      en_state_bound ? (work.x - state_slack()).cwiseAbs().maxCoeff() : 0.0;
+    work.dual_residual_state = (work.v - state_slack()).cwiseAbs().maxCoeff() * cache.rho;
+    work.primal_residual_input = (work.u - work.znew).cwiseAbs().maxCoeff();
+    work.dual_residual_input = (work.z - work.znew).cwiseAbs().maxCoeff() * cache.rho;
+
+    return work.primal_residual_state < settings.abs_pri_tol &&
+           work.primal_residual_input < settings.abs_pri_tol &&
+           work.dual_residual_state < settings.abs_dua_tol &&
+           work.dual_residual_input < settings.abs_dua_tol;
+  }
+};
+
+}  // namespace tinympc
+
+#endif  // AUTO_AIM__TINY_SOLVER_HPP
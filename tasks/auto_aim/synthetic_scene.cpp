@@ -0,0 +1,350 @@
+#include "synthetic_scene.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "target_model.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/yaml.hpp"
+
+namespace auto_aim
+{
+namespace
+{
+// 与Solver中PnP使用的尺寸一致，单位：m
+constexpr double LIGHTBAR_LENGTH = 56e-3;
+constexpr double BIG_ARMOR_WIDTH = 230e-3;
+constexpr double SMALL_ARMOR_WIDTH = 135e-3;
+
+constexpr double PLATE_HEIGHT = 125e-3;    // 装甲板贴纸的高度
+constexpr double LIGHTBAR_WIDTH = 6e-3;    // 灯条发光部分的宽度
+constexpr double HALO_WIDTH = 16e-3;       // 灯条光晕的宽度
+constexpr double HALO_LENGTH = 66e-3;      // 灯条光晕的长度
+constexpr double TEXTURE_SCALE = 2000;     // 贴图分辨率，单位：px/m
+constexpr double MAX_VIEW_ANGLE = 75 / 57.3;  // 视线与装甲板法向的夹角超过该值时灯条被遮挡
+
+// 每ms曝光的亮度(BGR)，曝光3ms左右时灯条饱和、数字图案较暗，与实际相机画面接近
+const cv::Scalar BACKGROUND_TOP{6, 5, 5};
+const cv::Scalar BACKGROUND_BOTTOM{12, 12, 11};
+const cv::Scalar PLATE{8, 8, 8};
+const cv::Scalar STICKER{30, 30, 30};
+const cv::Scalar LIGHTBAR_CORE{400, 400, 400};
+
+const std::vector<std::string> PATTERNS = {"1", "2", "3", "4", "5", "S", "O", "B", ""};
+
+cv::Scalar halo_color(Color color)
+{
+  switch (color) {
+    case red:
+      return {10, 30, 150};
+    case blue:
+      return {150, 60, 10};
+    case purple:
+      return {150, 20, 150};
+    default:
+      return {3, 3, 3};  // 熄灭
+  }
+}
+
+double armor_width(ArmorType type) { return type == big ? BIG_ARMOR_WIDTH : SMALL_ARMOR_WIDTH; }
+
+// 装甲板坐标系下的矩形，y向左，z向上，顺序为左上 右上 右下 左下
+std::vector<Eigen::Vector3d> rectangle(double y, double z, double width, double height)
+{
+  return {
+    {0, y + width / 2, z + height / 2},
+    {0, y - width / 2, z + height / 2},
+    {0, y - width / 2, z - height / 2},
+    {0, y + width / 2, z - height / 2}};
+}
+
+void fill(cv::Mat & img, const std::vector<cv::Point2f> & points, const cv::Scalar & color)
+{
+  constexpr int SHIFT = 4;  // 亚像素精度
+  std::vector<cv::Point> fixed;
+  for (const auto & p : points)
+    fixed.emplace_back(std::lround(p.x * (1 << SHIFT)), std::lround(p.y * (1 << SHIFT)));
+  cv::fillConvexPoly(img, fixed, color, cv::LINE_8, SHIFT);
+}
+
+// 装甲板贴纸：暗色底板上居中的数字图案
+cv::Mat make_texture(const SyntheticRobot & robot)
+{
+  cv::Size size(int(armor_width(robot.type) * TEXTURE_SCALE), int(PLATE_HEIGHT * TEXTURE_SCALE));
+  cv::Mat glyph = cv::Mat::zeros(size, CV_8UC1);
+  const auto & text = PATTERNS[robot.name];
+  if (!text.empty()) {
+    auto font = cv::FONT_HERSHEY_DUPLEX;
+    auto thickness = size.height / 12;
+    auto text_size = cv::getTextSize(text, font, 1.0, thickness, nullptr);
+    auto scale = size.height * 0.6 / text_size.height;
+    text_size = cv::getTextSize(text, font, scale, thickness, nullptr);
+    cv::Point origin((size.width - text_size.width) / 2, (size.height + text_size.height) / 2);
+    cv::putText(glyph, text, origin, font, scale, 255, thickness, cv::LINE_AA);
+  }
+
+  cv::Mat alpha, texture(size, CV_32FC3, PLATE);
+  cv::cvtColor(glyph, alpha, cv::COLOR_GRAY2BGR);
+  alpha.convertTo(alpha, CV_32FC3, 1.0 / 255);
+  cv::Mat sticker(size, CV_32FC3, STICKER);
+  texture += alpha.mul(sticker - texture);
+  return texture;
+}
+
+}  // namespace
+
+Eigen::Matrix<double, TARGET_STATE_DIM, 1> SyntheticRobot::state(double t) const
+{
+  Eigen::Vector3d p = xyz + v * t;
+  Eigen::Matrix<double, TARGET_STATE_DIM, 1> x;
+  x << p[0], v[0], p[1], v[1], p[2], v[2], tools::limit_rad(angle + w * t), w, r, l, h;
+  return x;
+}
+
+nlohmann::json SyntheticFrame::truth() const
+{
+  nlohmann::json json;
+  json["t"] = std::chrono::duration<double>(t.time_since_epoch()).count();
+  json["q"] = {q.w(), q.x(), q.y(), q.z()};
+  json["q_true"] = {q_true.w(), q_true.x(), q_true.y(), q_true.z()};
+  json["robots"] = nlohmann::json::array();
+  for (const auto & x : robots)
+    json["robots"].push_back(std::vector<double>(x.data(), x.data() + x.size()));
+  json["armors"] = nlohmann::json::array();
+  for (const auto & armor : armors) {
+    nlohmann::json points;
+    for (const auto & p : armor.points) points.push_back({p.x, p.y});
+    json["armors"].push_back(
+      {{"robot", armor.robot},
+       {"id", armor.id},
+       {"name", ARMOR_NAMES[armor.name]},
+       {"type", ARMOR_TYPES[armor.type]},
+       {"color", COLORS[armor.color]},
+       {"xyz", {armor.xyz_in_world[0], armor.xyz_in_world[1], armor.xyz_in_world[2]}},
+       {"ypr", {armor.ypr_in_world[0], armor.ypr_in_world[1], armor.ypr_in_world[2]}},
+       {"points", points}});
+  }
+  return json;
+}
+
+SyntheticScene::SyntheticScene(const std::string & config_path, const SceneOptions & options)
+: options_(options)
+{
+  auto yaml = tools::load(config_path);
+  auto R_gimbal2imubody_data = tools::read<std::vector<double>>(yaml, "R_gimbal2imubody");
+  auto R_camera2gimbal_data = tools::read<std::vector<double>>(yaml, "R_camera2gimbal");
+  auto t_camera2gimbal_data = tools::read<std::vector<double>>(yaml, "t_camera2gimbal");
+  auto camera_matrix_data = tools::read<std::vector<double>>(yaml, "camera_matrix");
+  auto distort_coeffs_data = tools::read<std::vector<double>>(yaml, "distort_coeffs");
+
+  R_gimbal2imubody_ = Eigen::Matrix<double, 3, 3, Eigen::RowMajor>(R_gimbal2imubody_data.data());
+  R_camera2gimbal_ = Eigen::Matrix<double, 3, 3, Eigen::RowMajor>(R_camera2gimbal_data.data());
+  t_camera2gimbal_ = Eigen::Vector3d(t_camera2gimbal_data.data());
+  camera_matrix_ = cv::Mat(3, 3, CV_64F, camera_matrix_data.data()).clone();
+  distort_coeffs_ = cv::Mat(distort_coeffs_data, true);
+
+  // 上暗下亮的渐变背景，模拟场地
+  background_.create(options_.height, options_.width, CV_32FC3);
+  for (int r = 0; r < options_.height; r++) {
+    auto k = double(r) / options_.height;
+    background_.row(r).setTo(BACKGROUND_TOP * (1 - k) + BACKGROUND_BOTTOM * k);
+  }
+}
+
+void SyntheticScene::add(const SyntheticRobot & robot)
+{
+  robots_.push_back(robot);
+  textures_.push_back(make_texture(robot));
+}
+
+SyntheticFrame SyntheticScene::render(double t) const
+{
+  SyntheticFrame frame;
+  auto t_ns = std::llround(t * 1e9);
+  frame.t = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(t_ns));
+
+  // 每帧的随机数只取决于seed和时刻
+  auto frame_seed = options_.seed * 0x9e3779b97f4a7c15ULL + uint64_t(t_ns);
+  std::mt19937_64 rng(frame_seed);
+
+  // 1. 图像：曝光时间内多次采样取平均，亮度与曝光时间成正比
+  cv::Mat radiance = cv::Mat::zeros(background_.size(), CV_32FC3), sample;
+  auto samples = std::max(1, options_.blur_samples);
+  for (int s = 0; s < samples; s++) {
+    auto ts = t + options_.exposure_ms * 1e-3 * ((s + 0.5) / samples - 0.5);
+    background_.copyTo(sample);
+    draw(sample, ts);
+    radiance += sample;
+  }
+  radiance *= options_.exposure_ms * options_.gain / samples;
+
+  if (options_.defocus > 0) cv::GaussianBlur(radiance, radiance, {0, 0}, options_.defocus);
+  if (options_.noise > 0) {
+    cv::Mat noise(radiance.size(), radiance.type());
+    cv::RNG(rng()).fill(noise, cv::RNG::NORMAL, 0, options_.noise);
+    radiance += noise;
+  }
+  radiance.convertTo(frame.img, CV_8UC3);  // 饱和截断
+
+  // 2. IMU：R_gimbal2world = R_gimbal2imubody^T * R_imubody2imuabs * R_gimbal2imubody
+  Eigen::Matrix3d R_gimbal2world = this->R_gimbal2world(t);
+  frame.q_true = Eigen::Quaterniond(
+    R_gimbal2imubody_ * R_gimbal2world * R_gimbal2imubody_.transpose());
+  frame.q = frame.q_true;
+  if (options_.imu_noise > 0) {
+    std::normal_distribution<double> normal(0, options_.imu_noise);
+    Eigen::Vector3d e{normal(rng), normal(rng), normal(rng)};
+    frame.q = (frame.q_true * Eigen::AngleAxisd(e.norm(), e.normalized())).normalized();
+  }
+
+  // 3. 真值
+  Eigen::Vector3d camera_xyz = R_gimbal2world * t_camera2gimbal_;
+  for (std::size_t i = 0; i < robots_.size(); i++) {
+    const auto & robot = robots_[i];
+    frame.robots.push_back(robot.state(t));
+    for (int id = 0; id < robot.armor_num; id++) {
+      auto pose = armor_pose(robot, t, id);
+      Eigen::Vector3d view = (camera_xyz - pose.xyz).normalized();
+      if (-pose.R.col(0).dot(view) < std::cos(MAX_VIEW_ANGLE)) continue;
+
+      SyntheticArmor armor;
+      auto width = armor_width(robot.type);
+      if (!project(R_gimbal2world, pose, rectangle(0, 0, width, LIGHTBAR_LENGTH), armor.points))
+        continue;
+      auto inside = std::all_of(armor.points.begin(), armor.points.end(), [&](const auto & p) {
+        return p.x >= 0 && p.y >= 0 && p.x < options_.width && p.y < options_.height;
+      });
+      if (!inside) continue;
+
+      armor.robot = i;
+      armor.id = id;
+      armor.name = robot.name;
+      armor.type = robot.type;
+      armor.color = robot.color;
+      armor.xyz_in_world = pose.xyz;
+      auto yaw = tools::limit_rad(frame.robots.back()[6] + id * 2 * M_PI / robot.armor_num);
+      armor.ypr_in_world = {yaw, robot.armor_pitch, 0};
+      frame.armors.push_back(armor);
+    }
+  }
+
+  return frame;
+}
+
+SyntheticScene::Pose SyntheticScene::armor_pose(
+  const SyntheticRobot & robot, double t, int id) const
+{
+  auto x = robot.state(t);
+  std::array<double, TARGET_STATE_DIM> state;
+  std::copy(x.data(), x.data() + TARGET_STATE_DIM, state.begin());
+  auto xyz = model::h_armor_xyz(state, id, robot.armor_num);
+  auto yaw = x[6] + id * 2 * M_PI / robot.armor_num;
+
+  // 装甲板位于中心-r*(cos yaw, sin yaw)处，x轴指向机器人内侧，倾角使外法向朝上
+  Pose pose;
+  pose.xyz = {xyz[0], xyz[1], xyz[2]};
+  pose.R = (Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) *
+            Eigen::AngleAxisd(robot.armor_pitch, Eigen::Vector3d::UnitY()))
+             .toRotationMatrix();
+  return pose;
+}
+
+Eigen::Matrix3d SyntheticScene::R_gimbal2world(double t) const
+{
+  auto yaw = options_.gimbal_yaw;
+  auto pitch = options_.gimbal_pitch;
+  if (options_.follow && !robots_.empty()) {
+    const auto & robot = robots_.front();
+    auto ypd = tools::xyz2ypd(robot.xyz + robot.v * t);
+    yaw = ypd[0];
+    pitch = ypd[1];
+  }
+  yaw += options_.wobble * std::sin(2 * M_PI * options_.wobble_freq * t);
+
+  // 绕y轴的正向旋转使x轴朝下，向上为正的pitch取反
+  return (Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) *
+          Eigen::AngleAxisd(-pitch, Eigen::Vector3d::UnitY()))
+    .toRotationMatrix();
+}
+
+bool SyntheticScene::project(
+  const Eigen::Matrix3d & R_gimbal2world, const Pose & pose,
+  const std::vector<Eigen::Vector3d> & xyz_in_armor, std::vector<cv::Point2f> & points) const
+{
+  std::vector<cv::Point3d> xyz_in_camera;
+  for (const auto & p : xyz_in_armor) {
+    Eigen::Vector3d xyz_in_gimbal = R_gimbal2world.transpose() * (pose.xyz + pose.R * p);
+    Eigen::Vector3d xyz = R_camera2gimbal_.transpose() * (xyz_in_gimbal - t_camera2gimbal_);
+    if (xyz[2] < 0.1) return false;
+    xyz_in_camera.emplace_back(xyz[0], xyz[1], xyz[2]);
+  }
+
+  cv::Vec3d zero(0, 0, 0);
+  cv::projectPoints(xyz_in_camera, zero, zero, camera_matrix_, distort_coeffs_, points);
+  return true;
+}
+
+void SyntheticScene::draw(cv::Mat & img, double t) const
+{
+  Eigen::Matrix3d R_gimbal2world = this->R_gimbal2world(t);
+  Eigen::Vector3d camera_xyz = R_gimbal2world * t_camera2gimbal_;
+
+  // 由远及近绘制，近处的机器人遮挡远处的
+  std::vector<std::pair<double, int>> order;
+  for (std::size_t i = 0; i < robots_.size(); i++) {
+    const auto & robot = robots_[i];
+    order.emplace_back(-(robot.xyz + robot.v * t - camera_xyz).norm(), i);
+  }
+  std::sort(order.begin(), order.end());
+
+  for (auto [_, i] : order) {
+    const auto & robot = robots_[i];
+    for (int id = 0; id < robot.armor_num; id++) {
+      auto pose = armor_pose(robot, t, id);
+      Eigen::Vector3d view = (camera_xyz - pose.xyz).normalized();
+      if (-pose.R.col(0).dot(view) < std::cos(MAX_VIEW_ANGLE)) continue;
+      draw_armor(img, R_gimbal2world, i, pose);
+    }
+  }
+}
+
+void SyntheticScene::draw_armor(
+  cv::Mat & img, const Eigen::Matrix3d & R_gimbal2world, int robot, const Pose & pose) const
+{
+  const auto & texture = textures_[robot];
+  auto width = armor_width(robots_[robot].type);
+  std::vector<cv::Point2f> points;
+
+  // 1. 贴纸，按四个角点透视变换，只处理其包围框
+  if (!project(R_gimbal2world, pose, rectangle(0, 0, width, PLATE_HEIGHT), points)) return;
+  auto box = cv::boundingRect(points) & cv::Rect(0, 0, img.cols, img.rows);
+  if (box.area() > 0) {
+    std::vector<cv::Point2f> src = {
+      {0, 0},
+      {float(texture.cols), 0},
+      {float(texture.cols), float(texture.rows)},
+      {0, float(texture.rows)}};
+    for (auto & p : points) p -= cv::Point2f(box.tl());
+    auto H = cv::getPerspectiveTransform(src, points);
+
+    cv::Mat warped, mask;
+    cv::warpPerspective(texture, warped, H, box.size());
+    cv::warpPerspective(cv::Mat(texture.size(), CV_32FC3, cv::Scalar::all(1)), mask, H, box.size());
+    cv::Mat blended = img(box).mul(cv::Scalar::all(1) - mask) + warped;
+    blended.copyTo(img(box));
+  }
+
+  // 2. 两侧灯条，先画光晕再画发光部分
+  auto color = halo_color(robots_[robot].color);
+  for (auto y : {width / 2, -width / 2}) {
+    if (project(R_gimbal2world, pose, rectangle(y, 0, HALO_WIDTH, HALO_LENGTH), points))
+      fill(img, points, color);
+    if (robots_[robot].color == extinguish) continue;
+    if (project(R_gimbal2world, pose, rectangle(y, 0, LIGHTBAR_WIDTH, LIGHTBAR_LENGTH), points))
+      fill(img, points, LIGHTBAR_CORE);
+  }
+}
+
+}  // namespace auto_aim
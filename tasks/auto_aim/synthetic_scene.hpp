@@ -0,0 +1,128 @@
+#ifndef AUTO_AIM__SYNTHETIC_SCENE_HPP
+#define AUTO_AIM__SYNTHETIC_SCENE_HPP
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+#include "armor.hpp"
+#include "target_snapshot.hpp"
+
+namespace auto_aim
+{
+// 合成场景中的一个机器人，运动模型与Target一致：匀速平移+匀速自转
+struct SyntheticRobot
+{
+  ArmorName name = three;
+  Color color = blue;
+  ArmorType type = small;
+  int armor_num = 4;
+  Eigen::Vector3d xyz{5, 0, 0};    // t=0时的旋转中心，世界坐标系，单位：m
+  Eigen::Vector3d v{0, 0, 0};      // 平移速度，单位：m/s
+  double angle = 0;                // t=0时第0块装甲板的朝向角，单位：rad
+  double w = 0;                    // 自转角速度，单位：rad/s
+  double r = 0.2;                  // 第0、2块装甲板的半径，单位：m
+  double l = 0;                    // 第1、3块装甲板的半径与r之差，单位：m
+  double h = 0;                    // 第1、3块装甲板的高度与第0、2块之差，单位：m
+  double armor_pitch = 15 / 57.3;  // 装甲板的倾角，前哨站为负，单位：rad
+
+  // t时刻的状态，排列与Target::ekf_x()一致：x vx y vy z vz a w r l h
+  Eigen::Matrix<double, TARGET_STATE_DIM, 1> state(double t) const;
+};
+
+struct SceneOptions
+{
+  int width = 1440;
+  int height = 1080;
+  double exposure_ms = 3;    // 曝光时间，决定画面亮度和运动模糊的长度
+  double gain = 1;           // 亮度增益
+  double noise = 2;          // 高斯噪声的标准差，单位：灰度
+  double defocus = 0;        // 失焦模糊的标准差，单位：px，0表示不模糊
+  int blur_samples = 4;      // 曝光时间内的采样次数，1表示无运动模糊
+  double imu_noise = 0;      // IMU姿态噪声每轴的标准差，单位：rad
+  bool follow = true;        // 云台瞄准第0个机器人的旋转中心，否则保持gimbal_yaw、gimbal_pitch
+  double gimbal_yaw = 0;     // rad
+  double gimbal_pitch = 0;   // 向上为正，rad
+  double wobble = 0;         // 云台yaw的正弦抖动幅值，rad
+  double wobble_freq = 1;    // Hz
+  uint64_t seed = 0;
+};
+
+// 一块可见装甲板的真值
+struct SyntheticArmor
+{
+  int robot;  // 机器人在场景中的序号
+  int id;     // 在机器人上的序号，与Target中一致
+  ArmorName name;
+  ArmorType type;
+  Color color;
+  Eigen::Vector3d xyz_in_world;     // 单位：m
+  Eigen::Vector3d ypr_in_world;     // 单位：rad
+
+  // 灯条端点的像素坐标，顺序与Armor::points一致：左上 右上 右下 左下
+  std::vector<cv::Point2f> points;
+};
+
+struct SyntheticFrame
+{
+  std::chrono::steady_clock::time_point t;  // 曝光中点
+  cv::Mat img;
+  Eigen::Quaterniond q;       // 带噪声的IMU姿态，与相机驱动给出的一致
+  Eigen::Quaterniond q_true;  // 无噪声的IMU姿态
+  std::vector<Eigen::Matrix<double, TARGET_STATE_DIM, 1>> robots;  // 各机器人的状态
+  std::vector<SyntheticArmor> armors;  // 朝向相机且完整位于画面内的装甲板，不考虑机器人之间的遮挡
+
+  nlohmann::json truth() const;
+};
+
+// 按配置文件中的相机内参、外参和R_gimbal2imubody渲染旋转、平移的机器人，并给出精确的真值
+// 灯条和装甲板尺寸与Solver一致；运动模糊由曝光时间内的多次采样平均得到
+// 同一时刻的渲染结果只取决于seed，与调用顺序无关，可在CI中复现
+class SyntheticScene
+{
+public:
+  SyntheticScene(const std::string & config_path, const SceneOptions & options = {});
+
+  void add(const SyntheticRobot & robot);
+
+  // t 单位：s，帧时间戳为steady_clock的零点加t
+  SyntheticFrame render(double t) const;
+
+private:
+  const SceneOptions options_;
+  Eigen::Matrix3d R_gimbal2imubody_;
+  Eigen::Matrix3d R_camera2gimbal_;
+  Eigen::Vector3d t_camera2gimbal_;
+  cv::Mat camera_matrix_;
+  cv::Mat distort_coeffs_;
+  cv::Mat background_;
+
+  std::vector<SyntheticRobot> robots_;
+  std::vector<cv::Mat> textures_;  // 各机器人装甲板的贴图，含数字图案
+
+  struct Pose
+  {
+    Eigen::Vector3d xyz;
+    Eigen::Matrix3d R;  // armor2world，x轴指向机器人内侧，y轴向左，z轴向上
+  };
+
+  Pose armor_pose(const SyntheticRobot & robot, double t, int id) const;
+  Eigen::Matrix3d R_gimbal2world(double t) const;
+
+  // 装甲板坐标系下的点投影到图像，有点位于相机后方时返回false
+  bool project(
+    const Eigen::Matrix3d & R_gimbal2world, const Pose & pose,
+    const std::vector<Eigen::Vector3d> & xyz_in_armor, std::vector<cv::Point2f> & points) const;
+
+  void draw(cv::Mat & img, double t) const;
+  void draw_armor(
+    cv::Mat & img, const Eigen::Matrix3d & R_gimbal2world, int robot, const Pose & pose) const;
+};
+
+}  // namespace auto_aim
+
+#endif  // AUTO_AIM__SYNTHETIC_SCENE_HPP
@@ -9,11 +9,11 @@
 #include <vector>
 
 #include "armor.hpp"
+#include "target_snapshot.hpp"
 #include "tools/extended_kalman_filter.hpp"
 
 namespace auto_aim
 {
-
 class Target
 {
 public:
@@ -37,6 +37,15 @@ public:
   const tools::ExtendedKalmanFilter & ekf() const;
   std::vector<Eigen::Vector4d> armor_xyza_list() const;
 
+  // 匀速平移+匀速自转模型的解析预测，不传播协方差
+  // t0 相对当前状态的起始时刻，单位：s
+  // dt 步长，单位：s
+  // n 步数，不超过MAX_PREDICT_STEPS
+  void predict_armors(double t0, double dt, int n, ArmorsPrediction & out) const;
+
+  // 供其他线程使用的只读快照
+  TargetSnapshot snapshot() const;
+
   bool diverged() const;
 
   bool convergened();
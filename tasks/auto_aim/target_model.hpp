@@ -0,0 +1,69 @@
+#ifndef AUTO_AIM__TARGET_MODEL_HPP
+#define AUTO_AIM__TARGET_MODEL_HPP
+
+#include <Eigen/Dense>
+#include <array>
+#include <cmath>
+
+#include "target_snapshot.hpp"
+#include "tools/autodiff.hpp"
+
+namespace auto_aim
+{
+// Target的运动模型和观测模型，以泛型函数实现
+// T为double时用于求值，T为tools::Dual时由tools::jacobian自动求雅可比矩阵
+// 新增模型只需编写泛型函数，无需手推雅可比矩阵
+namespace model
+{
+// 匀速平移+匀速自转
+template <typename T>
+std::array<T, TARGET_STATE_DIM> f(const std::array<T, TARGET_STATE_DIM> & x, double dt)
+{
+  auto x_prior = x;
+  x_prior[0] = x[0] + x[1] * dt;
+  x_prior[2] = x[2] + x[3] * dt;
+  x_prior[4] = x[4] + x[5] * dt;
+  x_prior[6] = tools::limit_rad(x[6] + x[7] * dt);
+  return x_prior;
+}
+
+// 第id块装甲板的xyz，与Target::h_armor_xyz一致
+template <typename T>
+std::array<T, 3> h_armor_xyz(const std::array<T, TARGET_STATE_DIM> & x, int id, int armor_num)
+{
+  using std::cos, std::sin;
+  auto angle = tools::limit_rad(x[6] + id * 2 * M_PI / armor_num);
+  auto use_l_h = (armor_num == 4) && (id == 1 || id == 3);
+  T r = use_l_h ? x[8] + x[9] : x[8];
+  T z = use_l_h ? x[4] + x[10] : x[4];
+  return {x[0] - r * cos(angle), x[2] - r * sin(angle), z};
+}
+
+// 观测量：第id块装甲板的yaw、pitch、distance和朝向角
+template <typename T>
+std::array<T, 4> h_armor_ypda(const std::array<T, TARGET_STATE_DIM> & x, int id, int armor_num)
+{
+  auto ypd = tools::xyz2ypd(h_armor_xyz(x, id, armor_num));
+  auto angle = tools::limit_rad(x[6] + id * 2 * M_PI / armor_num);
+  return {ypd[0], ypd[1], ypd[2], angle};
+}
+
+inline Eigen::Matrix<double, TARGET_STATE_DIM, TARGET_STATE_DIM> f_jacobian(
+  const Eigen::Matrix<double, TARGET_STATE_DIM, 1> & x, double dt)
+{
+  return tools::jacobian<TARGET_STATE_DIM, TARGET_STATE_DIM>(
+    [dt](const auto & x) { return f(x, dt); }, x);
+}
+
+inline Eigen::Matrix<double, 4, TARGET_STATE_DIM> h_jacobian(
+  const Eigen::Matrix<double, TARGET_STATE_DIM, 1> & x, int id, int armor_num)
+{
+  return tools::jacobian<4, TARGET_STATE_DIM>(
+    [id, armor_num](const auto & x) { return h_armor_ypda(x, id, armor_num); }, x);
+}
+
+}  // namespace model
+
+}  // namespace auto_aim
+
+#endif  // AUTO_AIM__TARGET_MODEL_HPP
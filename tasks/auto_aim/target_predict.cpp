@@ -0,0 +1,27 @@
+#include "target.hpp"
+
+namespace auto_aim
+{
+TargetSnapshot Target::snapshot() const
+{
+  TargetSnapshot snapshot;
+  snapshot.name = name;
+  snapshot.armor_type = armor_type;
+  snapshot.priority = priority;
+  snapshot.armor_num = armor_num_;
+  snapshot.jumped = jumped;
+  snapshot.last_id = last_id;
+  snapshot.t = t_;
+  for (int i = 0; i < TARGET_STATE_DIM; i++) {
+    snapshot.x[i] = ekf_.x[i];
+    snapshot.P_diag[i] = ekf_.P(i, i);
+  }
+  return snapshot;
+}
+
+void Target::predict_armors(double t0, double dt, int n, ArmorsPrediction & out) const
+{
+  snapshot().predict_armors(t0, dt, n, out);
+}
+
+}  // namespace auto_aim
@@ -0,0 +1,70 @@
+#include "target_snapshot.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "tools/math_tools.hpp"
+
+namespace auto_aim
+{
+TargetSnapshot TargetSnapshot::predicted(double dt) const
+{
+  auto snapshot = *this;
+  snapshot.x[0] += x[1] * dt;
+  snapshot.x[2] += x[3] * dt;
+  snapshot.x[4] += x[5] * dt;
+  snapshot.x[6] = tools::limit_rad(x[6] + x[7] * dt);
+  snapshot.t = t + std::chrono::microseconds(static_cast<int64_t>(dt * 1e6));
+  return snapshot;
+}
+
+TargetSnapshot TargetSnapshot::predicted(std::chrono::steady_clock::time_point t) const
+{
+  return predicted(tools::delta_time(t, this->t));
+}
+
+int TargetSnapshot::armor_xyza_list(std::array<Eigen::Vector4d, MAX_ARMOR_NUM> & xyza_list) const
+{
+  if (armor_num > MAX_ARMOR_NUM) throw std::out_of_range("armor_xyza_list: too many armors!");
+
+  for (int id = 0; id < armor_num; id++) {
+    auto use_l_h = (armor_num == 4) && (id == 1 || id == 3);
+    auto armor_r = use_l_h ? x[8] + x[9] : x[8];
+    auto angle = tools::limit_rad(x[6] + id * 2 * CV_PI / armor_num);
+    xyza_list[id] = {
+      x[0] - armor_r * std::cos(angle), x[2] - armor_r * std::sin(angle),
+      use_l_h ? x[4] + x[10] : x[4], angle};
+  }
+  return armor_num;
+}
+
+void TargetSnapshot::predict_armors(double t0, double dt, int n, ArmorsPrediction & out) const
+{
+  if (n < 0 || n > MAX_PREDICT_STEPS) throw std::out_of_range("predict_armors: n out of range!");
+  if (armor_num > MAX_ARMOR_NUM) throw std::out_of_range("predict_armors: too many armors!");
+
+  const double cx = x[0], vx = x[1], cy = x[2], vy = x[3], cz = x[4], vz = x[5];
+  const double a0 = x[6], w = x[7], r = x[8], l = x[9], h = x[10];
+
+  out.armor_num = armor_num;
+  out.steps = n;
+
+  for (int id = 0; id < armor_num; id++) {
+    // 与Target::h_armor_xyz保持一致：四装甲板目标的1、3号装甲板使用另一组半径和高度
+    auto use_l_h = (armor_num == 4) && (id == 1 || id == 3);
+    auto armor_r = use_l_h ? r + l : r;
+    auto armor_dz = use_l_h ? h : 0.0;
+    auto a_offset = id * 2 * CV_PI / armor_num;
+
+    for (int i = 0; i < n; i++) {
+      auto t = t0 + i * dt;
+      auto angle = tools::limit_rad(a0 + w * t + a_offset);
+      out.x(id, i) = cx + vx * t - armor_r * std::cos(angle);
+      out.y(id, i) = cy + vy * t - armor_r * std::sin(angle);
+      out.z(id, i) = cz + vz * t + armor_dz;
+      out.a(id, i) = angle;
+    }
+  }
+}
+
+}  // namespace auto_aim
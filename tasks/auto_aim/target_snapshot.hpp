@@ -0,0 +1,66 @@
+#ifndef AUTO_AIM__TARGET_SNAPSHOT_HPP
+#define AUTO_AIM__TARGET_SNAPSHOT_HPP
+
+#include <Eigen/Dense>
+#include <array>
+#include <chrono>
+#include <type_traits>
+
+#include "armor.hpp"
+
+namespace auto_aim
+{
+constexpr int TARGET_STATE_DIM = 11;  // x vx y vy z vz a w r l h
+constexpr int MAX_ARMOR_NUM = 4;
+constexpr int MAX_PREDICT_STEPS = 128;
+
+// 装甲板预测结果，SoA布局：每行对应一块装甲板，每列对应一个时刻
+struct ArmorsPrediction
+{
+  int armor_num = 0;
+  int steps = 0;
+  Eigen::Matrix<double, MAX_ARMOR_NUM, MAX_PREDICT_STEPS> x;
+  Eigen::Matrix<double, MAX_ARMOR_NUM, MAX_PREDICT_STEPS> y;
+  Eigen::Matrix<double, MAX_ARMOR_NUM, MAX_PREDICT_STEPS> z;
+  Eigen::Matrix<double, MAX_ARMOR_NUM, MAX_PREDICT_STEPS> a;
+};
+
+// Target的只读快照，平凡可复制，用于跨线程传递
+// 拷贝不涉及堆内存分配，规划线程只接触快照而不接触Target本身
+struct TargetSnapshot
+{
+  ArmorName name;
+  ArmorType armor_type;
+  ArmorPriority priority;
+  int armor_num;
+  bool jumped;
+  int last_id;  // debug only
+  std::chrono::steady_clock::time_point t;
+
+  std::array<double, TARGET_STATE_DIM> x;       // EKF状态
+  std::array<double, TARGET_STATE_DIM> P_diag;  // EKF协方差对角线
+
+  Eigen::Map<const Eigen::Matrix<double, TARGET_STATE_DIM, 1>> ekf_x() const
+  {
+    return Eigen::Map<const Eigen::Matrix<double, TARGET_STATE_DIM, 1>>(x.data());
+  }
+
+  // 仅推进状态均值，不传播协方差
+  TargetSnapshot predicted(double dt) const;
+  TargetSnapshot predicted(std::chrono::steady_clock::time_point t) const;
+
+  // 返回装甲板数量，结果写入xyza_list
+  int armor_xyza_list(std::array<Eigen::Vector4d, MAX_ARMOR_NUM> & xyza_list) const;
+
+  // 匀速平移+匀速自转模型的解析预测
+  // t0 相对快照时刻的起始时间，单位：s
+  // dt 步长，单位：s
+  // n 步数，不超过MAX_PREDICT_STEPS
+  void predict_armors(double t0, double dt, int n, ArmorsPrediction & out) const;
+};
+
+static_assert(std::is_trivially_copyable_v<TargetSnapshot>);
+
+}  // namespace auto_aim
+
+#endif  // AUTO_AIM__TARGET_SNAPSHOT_HPP
@@ -51,7 +51,7 @@ io::Command Decider::decide(
       delta_angle = this->delta_angle(armors, cams[count_]->device_name);
     }
 
-    tools::logger()->debug(
+    TOOLS_LOG_DEBUG(
       "[{} camera] delta yaw:{:.2f},target pitch:{:.2f},armor number:{},armor name:{}",
       (count_ == 2 ? "back" : cams[count_]->device_name), delta_angle[0], delta_angle[1],
       armors.size(), auto_aim::ARMOR_NAMES[armors.front().name]);
@@ -79,7 +79,7 @@ io::Command Decider::decide(
 
   if (!empty) {
     auto delta_angle = this->delta_angle(armors, "back");
-    tools::logger()->debug(
+    TOOLS_LOG_DEBUG(
       "[back camera] delta yaw:{:.2f},target pitch:{:.2f},armor number:{},armor name:{}",
       delta_angle[0], delta_angle[1], armors.size(), auto_aim::ARMOR_NAMES[armors.front().name]);
 
@@ -99,8 +99,8 @@ io::Command Decider::decide(const std::vector<DetectionResult> & detection_queue
 
   DetectionResult dr = detection_queue.front();
   if (dr.armors.empty()) return io::Command{false, false, 0, 0};
-  tools::logger()->info(
-    "omniperceptron find {},delta yaw is {:.4f}", auto_aim::ARMOR_NAMES[dr.armors.front().name],
+  TOOLS_LOG_INFO_LIMITED(
+    10, "omniperceptron find {},delta yaw is {:.4f}", auto_aim::ARMOR_NAMES[dr.armors.front().name],
     dr.delta_yaw * 57.3);
 
   return io::Command{true, false, dr.delta_yaw, dr.delta_pitch};
@@ -190,12 +190,19 @@ void Decider::sort(std::vector<DetectionResult> & detection_queue)
 Eigen::Vector4d Decider::get_target_info(
   const std::list<auto_aim::Armor> & armors, const std::list<auto_aim::Target> & targets)
 {
-  if (armors.empty() || targets.empty()) return Eigen::Vector4d::Zero();
+  if (targets.empty()) return Eigen::Vector4d::Zero();
 
-  auto target = targets.front();
+  return get_target_info(armors, targets.front().snapshot());
+}
+
+Eigen::Vector4d Decider::get_target_info(
+  const std::list<auto_aim::Armor> & armors,
+  const std::optional<auto_aim::TargetSnapshot> & target)
+{
+  if (armors.empty() || !target.has_value()) return Eigen::Vector4d::Zero();
 
   for (const auto & armor : armors) {
-    if (armor.name == target.name) {
+    if (armor.name == target->name) {
       return Eigen::Vector4d{
         armor.xyz_in_gimbal[0], armor.xyz_in_gimbal[1], 1,
         static_cast<double>(armor.name) + 1};  //避免歧义+1(详见通信协议)
@@ -4,6 +4,7 @@
 #include <Eigen/Dense>  // 必须在opencv2/core/eigen.hpp上面
 #include <iostream>
 #include <list>
+#include <optional>
 #include <unordered_map>
 
 #include "detection.hpp"
@@ -12,6 +13,7 @@
 #include "io/usbcamera/usbcamera.hpp"
 #include "tasks/auto_aim/armor.hpp"
 #include "tasks/auto_aim/target.hpp"
+#include "tasks/auto_aim/target_snapshot.hpp"
 #include "tasks/auto_aim/yolo.hpp"
 
 namespace omniperception
@@ -42,6 +44,10 @@ public:
   Eigen::Vector4d get_target_info(
     const std::list<auto_aim::Armor> & armors, const std::list<auto_aim::Target> & targets);
 
+  Eigen::Vector4d get_target_info(
+    const std::list<auto_aim::Armor> & armors,
+    const std::optional<auto_aim::TargetSnapshot> & target);
+
   void get_invincible_armor(const std::vector<int8_t> & invincible_enemy_ids);
 
   void get_auto_aim_target(
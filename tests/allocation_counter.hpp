@@ -0,0 +1,33 @@
+#ifndef TESTS__ALLOCATION_COUNTER_HPP
+#define TESTS__ALLOCATION_COUNTER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// 替换全局operator new/delete以统计堆分配次数，供pipeline_bench和micro_bench使用
+// 替换函数不能为inline，因此每个可执行文件只能有一个源文件包含本头文件
+
+namespace allocation_counter
+{
+// 所有线程的分配次数，适合被测代码会在其他线程中分配的场景
+inline std::atomic<uint64_t> total = 0;
+
+// 本线程的分配次数，多个线程同时测量时互不干扰
+inline thread_local uint64_t local = 0;
+}  // namespace allocation_counter
+
+void * operator new(std::size_t size)
+{
+  allocation_counter::local++;
+  allocation_counter::total.fetch_add(1, std::memory_order_relaxed);
+  if (auto p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+#endif  // TESTS__ALLOCATION_COUNTER_HPP
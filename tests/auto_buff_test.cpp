@@ -1,7 +1,6 @@
 #include <fmt/core.h>
 
 #include <chrono>
-#include <fstream>
 #include <nlohmann/json.hpp>
 #include <opencv2/opencv.hpp>
 
@@ -11,6 +10,7 @@
 #include "tasks/auto_buff/buff_target.hpp"
 #include "tasks/auto_buff/buff_type.hpp"
 #include "tools/exiter.hpp"
+#include "tools/frame_log.hpp"
 #include "tools/img_tools.hpp"
 #include "tools/logger.hpp"
 #include "tools/math_tools.hpp"
@@ -21,7 +21,8 @@ const std::string keys =
   "{config-path c  | configs/demo.yaml    | yaml配置文件的路径}"
   "{start-index s  | 0                      | 视频起始帧下标    }"
   "{end-index e    | 0                      | 视频结束帧下标    }"
-  "{@input-path    |                        | avi和txt文件的路径}";
+  "{start-time t   | -1                     | 视频起始时间(s)，不小于0时代替start-index }"
+  "{@input-path    |                        | 录像目录，旧版avi+txt先用import_video转换 }";
 
 int main(int argc, char * argv[])
 {
@@ -35,14 +36,16 @@ int main(int argc, char * argv[])
   auto config_path = cli.get<std::string>("config-path");
   auto start_index = cli.get<int>("start-index");
   auto end_index = cli.get<int>("end-index");
+  auto start_time = cli.get<double>("start-time");
 
   tools::Plotter plotter;
   tools::Exiter exiter;
 
-  auto video_path = fmt::format("{}.avi", input_path);
-  auto text_path = fmt::format("{}.txt", input_path);
-  cv::VideoCapture video(video_path);
-  std::ifstream text(text_path);
+  tools::FrameLogReader recording(input_path);
+  if (start_time >= 0 && recording.size() > 0) {
+    auto since_begin = std::chrono::microseconds(int64_t(start_time * 1e6));
+    start_index = recording.find(recording.timestamp(0) + since_begin);
+  }
 
   auto_buff::Buff_Detector detector(config_path);
   auto_buff::Solver solver(config_path);
@@ -51,30 +54,22 @@ int main(int argc, char * argv[])
   auto_buff::Aimer aimer(config_path);
 
   cv::Mat img, drawing;
-  auto t0 = std::chrono::steady_clock::now();
+  tools::FrameLogReader::Frame frame;
 
   io::Command last_command;
   double last_t = -1;
 
-  video.set(cv::CAP_PROP_POS_FRAMES, start_index);
-  for (int i = 0; i < start_index; i++) {
-    double t, w, x, y, z;
-    text >> t >> w >> x >> y >> z;
-  }
-
   for (int frame_count = start_index; !exiter.exit(); frame_count++) {
     if (end_index > 0 && frame_count > end_index) break;
 
-    video.read(img);
-    if (img.empty()) break;
+    if (!recording.read(frame_count, frame)) break;
+    img = frame.img;
 
-    double t, w, x, y, z;
-    text >> t >> w >> x >> y >> z;
-    auto timestamp = t0 + std::chrono::microseconds(int(t * 1e6));
+    auto timestamp = frame.timestamp;
 
     /// 自瞄核心逻辑
 
-    solver.set_R_gimbal2world({w, x, y, z});
+    solver.set_R_gimbal2world(frame.q);
 
     auto power_runes = detector.detect(img);
 
@@ -173,7 +168,6 @@ int main(int argc, char * argv[])
     }
   }
   cv::destroyAllWindows();
-  text.close();  // 关闭文件
 
   return 0;
 }
\ No newline at end of file
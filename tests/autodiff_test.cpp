@@ -0,0 +1,136 @@
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include <random>
+
+#include "tasks/auto_aim/target_model.hpp"
+#include "tools/autodiff.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+
+const std::string keys =
+  "{help h usage ? |        | 输出命令行参数说明 }"
+  "{n              | 100000 | 微基准重复次数    }";
+
+// 手推的装甲板xyza对状态的雅可比矩阵，与Target::h_jacobian一致
+Eigen::MatrixXd hand_h_jacobian(const Eigen::VectorXd & x, int id, int armor_num)
+{
+  auto angle = tools::limit_rad(x[6] + id * 2 * CV_PI / armor_num);
+  auto use_l_h = (armor_num == 4) && (id == 1 || id == 3);
+  auto r = (use_l_h) ? x[8] + x[9] : x[8];
+  auto dx_da = r * std::sin(angle);
+  auto dy_da = -r * std::cos(angle);
+  auto dx_dr = -std::cos(angle);
+  auto dy_dr = -std::sin(angle);
+  auto dx_dl = (use_l_h) ? -std::cos(angle) : 0.0;
+  auto dy_dl = (use_l_h) ? -std::sin(angle) : 0.0;
+  auto dz_dh = (use_l_h) ? 1.0 : 0.0;
+
+  // clang-format off
+  Eigen::MatrixXd H_armor_xyza{
+    {1, 0, 0, 0, 0, 0, dx_da, 0, dx_dr, dx_dl,     0},
+    {0, 0, 1, 0, 0, 0, dy_da, 0, dy_dr, dy_dl,     0},
+    {0, 0, 0, 0, 1, 0,     0, 0,     0,     0, dz_dh},
+    {0, 0, 0, 0, 0, 0,     1, 0,     0,     0,     0}
+  };
+  // clang-format on
+
+  Eigen::Vector3d armor_xyz{
+    x[0] - r * std::cos(angle), x[2] - r * std::sin(angle), use_l_h ? x[4] + x[10] : x[4]};
+  Eigen::MatrixXd H_armor_ypd = tools::xyz2ypd_jacobian(armor_xyz);
+
+  // clang-format off
+  Eigen::MatrixXd H_armor_ypda{
+    {H_armor_ypd(0, 0), H_armor_ypd(0, 1), H_armor_ypd(0, 2), 0},
+    {H_armor_ypd(1, 0), H_armor_ypd(1, 1), H_armor_ypd(1, 2), 0},
+    {H_armor_ypd(2, 0), H_armor_ypd(2, 1), H_armor_ypd(2, 2), 0},
+    {                0,                 0,                 0, 1}
+  };
+  // clang-format on
+
+  return H_armor_ypda * H_armor_xyza;
+}
+
+Eigen::MatrixXd hand_f_jacobian(double dt)
+{
+  // clang-format off
+  Eigen::MatrixXd F{
+    {1, dt,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    {0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    {0,  0,  1, dt,  0,  0,  0,  0,  0,  0,  0},
+    {0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0},
+    {0,  0,  0,  0,  1, dt,  0,  0,  0,  0,  0},
+    {0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0},
+    {0,  0,  0,  0,  0,  0,  1, dt,  0,  0,  0},
+    {0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0},
+    {0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0},
+    {0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0},
+    {0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1}
+  };
+  // clang-format on
+  return F;
+}
+
+template <typename F>
+double time_us(F && f, int n)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) f();
+  return tools::delta_time(std::chrono::steady_clock::now(), start) * 1e6 / n;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto n = cli.get<int>("n");
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> pos(-5, 5);
+  std::uniform_real_distribution<double> angle(-CV_PI, CV_PI);
+  std::uniform_real_distribution<double> small(0.05, 0.3);
+
+  // 1. 正确性：随机状态下与手推结果比较
+  double max_error = 0;
+  for (int k = 0; k < 1000; k++) {
+    Eigen::Vector3d xyz{pos(gen), pos(gen), pos(gen)};
+    max_error =
+      std::max(max_error, (tools::xyz2ypd_jacobian_ad(xyz) - tools::xyz2ypd_jacobian(xyz)).norm());
+
+    Eigen::Vector3d ypd{angle(gen), angle(gen) / 2, std::abs(pos(gen)) + 0.5};
+    max_error =
+      std::max(max_error, (tools::ypd2xyz_jacobian_ad(ypd) - tools::ypd2xyz_jacobian(ypd)).norm());
+
+    Eigen::Matrix<double, auto_aim::TARGET_STATE_DIM, 1> x;
+    x << pos(gen), pos(gen), pos(gen), pos(gen), pos(gen), pos(gen), angle(gen), pos(gen),
+      small(gen), small(gen) - 0.15, small(gen) - 0.15;
+    for (int armor_num : {2, 3, 4}) {
+      for (int id = 0; id < armor_num; id++) {
+        auto H_ad = auto_aim::model::h_jacobian(x, id, armor_num);
+        max_error = std::max(max_error, (H_ad - hand_h_jacobian(x, id, armor_num)).norm());
+      }
+    }
+
+    auto dt = small(gen);
+    max_error = std::max(max_error, (auto_aim::model::f_jacobian(x, dt) - hand_f_jacobian(dt)).norm());
+  }
+  tools::logger()->info("max jacobian error: {:.3e}", max_error);
+
+  // 2. 微基准
+  Eigen::Vector3d xyz{3, 1, 0.5};
+  Eigen::Matrix<double, auto_aim::TARGET_STATE_DIM, 1> x;
+  x << 3, 0.5, 1, -0.2, 0.1, 0, 0.3, 5, 0.2, 0.05, 0.02;
+  double sink = 0;
+
+  auto xyz2ypd_hand = time_us([&] { sink += tools::xyz2ypd_jacobian(xyz)(0, 0); }, n);
+  auto xyz2ypd_ad = time_us([&] { sink += tools::xyz2ypd_jacobian_ad(xyz)(0, 0); }, n);
+  auto h_hand = time_us([&] { sink += hand_h_jacobian(x, 1, 4)(0, 0); }, n);
+  auto h_ad = time_us([&] { sink += auto_aim::model::h_jacobian(x, 1, 4)(0, 0); }, n);
+
+  tools::logger()->info("xyz2ypd_jacobian hand: {:.3f}us, ad: {:.3f}us", xyz2ypd_hand, xyz2ypd_ad);
+  tools::logger()->info("h_jacobian hand: {:.3f}us, ad: {:.3f}us ({})", h_hand, h_ad, sink > 0);
+
+  return max_error < 1e-9 ? 0 : 1;
+}
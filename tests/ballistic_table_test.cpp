@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include <random>
+
+#include "tools/ballistic_table.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/trajectory.hpp"
+
+const std::string keys =
+  "{help h usage ? |      | 输出命令行参数说明                        }"
+  "{k              | 0.02 | 阻力系数(1/m)，17mm弹丸约0.02，42mm约0.01 }"
+  "{n              | 300  | 与数值积分比较的随机样本数                 }"
+  "{output o       |      | 保存表格的路径，为空时不保存               }";
+
+// 在表格范围内随机取(v0, d, h)，比较查表与逐点数值积分的精度和速度
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto k = cli.get<double>("k");
+  auto n = cli.get<int>("n");
+  auto output = cli.get<std::string>("output");
+
+  tools::BallisticTableParams params;
+  params.k = k;
+
+  auto start = std::chrono::steady_clock::now();
+  tools::BallisticTable table(params);
+  auto build_s = tools::delta_time(std::chrono::steady_clock::now(), start);
+  tools::logger()->info("build: {:.2f}s", build_s);
+
+  if (!output.empty()) {
+    table.save(output);
+    auto loaded = tools::BallisticTable::load(output, params);
+    if (!loaded || loaded->query(22, 5, 0.5).pitch != table.query(22, 5, 0.5).pitch) {
+      tools::logger()->error("Failed to reload {}", output);
+      return 1;
+    }
+  }
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> v0_dist(params.v0_min, params.v0_max);
+  std::uniform_real_distribution<double> d_dist(1.0, params.d_max);
+  std::uniform_real_distribution<double> h_dist(params.h_min, params.h_max);
+
+  constexpr double MAX_EVAL_PITCH = 20 / 57.3;
+
+  double integrate_us = 0, max_drag_effect = 0, max_pitch_error = 0, max_time_error = 0;
+  std::vector<double> pitch_errors, time_errors;
+  int mismatch = 0;
+  for (int i = 0; i < n; i++) {
+    auto v0 = v0_dist(rng), d = d_dist(rng), h = h_dist(rng);
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto truth = tools::Trajectory::integrate(k, v0, d, h);
+    integrate_us += tools::delta_time(std::chrono::steady_clock::now(), t0) * 1e6;
+
+    auto result = table.query(v0, d, h);
+    if (truth.unsolvable || result.unsolvable) {
+      // 可达边界附近的插值单元含不可达顶点，只允许查表比积分更保守
+      if (truth.unsolvable && !result.unsolvable) mismatch++;
+      continue;
+    }
+
+    auto pitch_error = std::abs(result.pitch - truth.pitch);
+    auto time_error = std::abs(result.fly_time - truth.fly_time);
+    max_pitch_error = std::max(max_pitch_error, pitch_error);
+    max_time_error = std::max(max_time_error, time_error);
+
+    // 接近射程极限时出射角随高度剧烈变化，插值误差集中在这一区域，精度只在常用的出射角范围内考核
+    if (std::abs(truth.pitch) > MAX_EVAL_PITCH) continue;
+    pitch_errors.push_back(pitch_error);
+    time_errors.push_back(time_error);
+
+    auto drag_free = tools::Trajectory(v0, d, h);
+    if (!drag_free.unsolvable)
+      max_drag_effect = std::max(max_drag_effect, std::abs(drag_free.pitch - truth.pitch));
+  }
+
+  // 网格外不外推，应视为unsolvable
+  auto outside = 0;
+  for (auto [v0, d, h] : {std::array<double, 3>{params.v0_max + 1, 5, 0},
+                          {22, params.d_max + 1, 0},
+                          {22, params.d_min / 2, 0},
+                          {22, 5, params.h_max + 0.5}})
+    if (!table.query(v0, d, h).unsolvable) outside++;
+
+  // 吞吐量：与规划时域相同，每批100个点
+  constexpr int BATCH = 100;
+  constexpr int REPEAT = 10000;
+  std::vector<double> d(BATCH), h(BATCH), pitch(BATCH), fly_time(BATCH);
+  for (int i = 0; i < BATCH; i++) {
+    d[i] = d_dist(rng);
+    h[i] = h_dist(rng);
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < REPEAT; r++)
+    table.query(22, d.data(), h.data(), pitch.data(), fly_time.data(), BATCH);
+  auto batch_ns = tools::delta_time(std::chrono::steady_clock::now(), t0) * 1e9 / (REPEAT * BATCH);
+
+  auto sink = 0.0;
+  t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < REPEAT; r++)
+    for (int i = 0; i < BATCH; i++) sink += tools::Trajectory(22, d[i], h[i]).pitch;
+  auto analytic_ns =
+    tools::delta_time(std::chrono::steady_clock::now(), t0) * 1e9 / (REPEAT * BATCH);
+
+  auto percentile = [](std::vector<double> errors, double p) {
+    if (errors.empty()) return 0.0;
+    std::sort(errors.begin(), errors.end());
+    return errors[std::min<std::size_t>(errors.size() * p, errors.size() - 1)];
+  };
+  auto pitch_p99 = percentile(pitch_errors, 0.99), time_p99 = percentile(time_errors, 0.99);
+
+  tools::logger()->info(
+    "{}/{} within ±{:.0f}°, {} mismatch, {} solvable outside the grid, drag effect max {:.1f}mrad",
+    pitch_errors.size(), n, MAX_EVAL_PITCH * 57.3, mismatch, outside, max_drag_effect * 1e3);
+  tools::logger()->info(
+    "pitch error p99 {:.3f}mrad max {:.3f}mrad, fly time error p99 {:.3f}ms max {:.3f}ms",
+    pitch_p99 * 1e3, percentile(pitch_errors, 1.0) * 1e3, time_p99 * 1e3,
+    percentile(time_errors, 1.0) * 1e3);
+  tools::logger()->info(
+    "all solvable: pitch error max {:.3f}mrad, fly time error max {:.3f}ms", max_pitch_error * 1e3,
+    max_time_error * 1e3);
+  tools::logger()->info(
+    "integrate {:.1f}us, table batch {:.1f}ns, drag-free analytic {:.1f}ns ({:.0f})",
+    integrate_us / n, batch_ns, analytic_ns, sink);
+
+  return (percentile(pitch_errors, 1.0) < 1e-3 && percentile(time_errors, 1.0) < 1e-3 &&
+          mismatch == 0 && outside == 0)
+           ? 0
+           : 1;
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <opencv2/opencv.hpp>
+
+#include "tasks/auto_aim/planner/batch_solver.hpp"
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tests/planner_reference.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/trajectory.hpp"
+#include "tools/yaml.hpp"
+
+const std::string keys =
+  "{help h usage ? |      | 输出命令行参数说明    }"
+  "{d              | 3.0  | Target距离(m)       }"
+  "{w              | 5.0  | Target角速度(rad/s) }"
+  "{n              | 2000 | 规划次数             }"
+  "{@config-path   |      | yaml配置文件路径     }";
+
+using auto_aim::DT;
+using auto_aim::HALF_HORIZON;
+using auto_aim::HORIZON;
+using Problem = tinympc::TinySolver<2, 1, HORIZON>;
+
+void setup(Problem & problem, const YAML::Node & yaml, const std::string & axis)
+{
+  auto max_acc = tools::read<double>(yaml, "max_" + axis + "_acc");
+  auto Q = tools::read<std::vector<double>>(yaml, "Q_" + axis);
+  auto R = tools::read<std::vector<double>>(yaml, "R_" + axis);
+
+  Eigen::Matrix2d A{{1, DT}, {0, 1}};
+  Eigen::Vector2d B{0, DT};
+  Eigen::Vector2d f{0, 0};
+  problem.setup(A, B, f, Eigen::Vector2d(Q.data()), Eigen::Matrix<double, 1, 1>(R.data()), 1.0);
+  problem.set_input_bound(
+    Problem::InputTrajectory::Constant(-max_acc), Problem::InputTrajectory::Constant(max_acc));
+  problem.settings.max_iter = 10;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  auto config_path = cli.get<std::string>("@config-path");
+  auto d = cli.get<double>("d");
+  auto w = cli.get<double>("w");
+  auto n = cli.get<int>("n");
+  if (cli.has("help") || !cli.has("@config-path")) {
+    cli.printMessage();
+    return 0;
+  }
+
+  auto yaml = tools::load(config_path);
+
+  // 1. 逐个求解的yaw和pitch
+  Problem yaw_solver, pitch_solver;
+  setup(yaw_solver, yaml, "yaw");
+  setup(pitch_solver, yaml, "pitch");
+
+  // 2. yaw和pitch作为两个通道联合求解
+  auto joint_solver = std::make_unique<auto_aim::JointSolver>();
+  joint_solver->setup(auto_aim::YAW_LANE, yaw_solver);
+  joint_solver->setup(auto_aim::PITCH_LANE, pitch_solver);
+  joint_solver->settings.max_iter = 10;
+
+  auto_aim::Target target(d, w, 0.2, 0.1);
+  double sequential_us = 0, joint_us = 0, max_diff = 0;
+  int sequential_iter = 0, joint_iter = 0, iter_mismatch = 0;
+
+  for (int k = 0; k < n; k++) {
+    target.predict(0.01);
+    auto traj = reference(target.snapshot(), 22);
+
+    auto start = std::chrono::steady_clock::now();
+    yaw_solver.set_x0(traj.block<2, 1>(0, 0));
+    yaw_solver.work.Xref = traj.topRows<2>();
+    yaw_solver.solve();
+    pitch_solver.set_x0(traj.block<2, 1>(2, 0));
+    pitch_solver.work.Xref = traj.bottomRows<2>();
+    pitch_solver.solve();
+    auto mid = std::chrono::steady_clock::now();
+    joint_solver->set_x0(auto_aim::YAW_LANE, traj.block<2, 1>(0, 0));
+    joint_solver->set_x_ref(auto_aim::YAW_LANE, traj.topRows<2>());
+    joint_solver->set_x0(auto_aim::PITCH_LANE, traj.block<2, 1>(2, 0));
+    joint_solver->set_x_ref(auto_aim::PITCH_LANE, traj.bottomRows<2>());
+    joint_solver->solve();
+    auto end = std::chrono::steady_clock::now();
+
+    sequential_us += tools::delta_time(mid, start) * 1e6;
+    joint_us += tools::delta_time(end, mid) * 1e6;
+    sequential_iter += yaw_solver.work.iter + pitch_solver.work.iter;
+    joint_iter += joint_solver->work.iter;
+
+    const auto & yaw = joint_solver->solution[auto_aim::YAW_LANE];
+    const auto & pitch = joint_solver->solution[auto_aim::PITCH_LANE];
+    if (yaw.iter != yaw_solver.work.iter || pitch.iter != pitch_solver.work.iter) iter_mismatch++;
+    max_diff = std::max(
+      {max_diff, (yaw.x - yaw_solver.work.x).cwiseAbs().maxCoeff(),
+       (pitch.x - pitch_solver.work.x).cwiseAbs().maxCoeff()});
+  }
+
+  // 3. 只启用yaw通道，pitch通道的参考轨迹远离当前解也不延长迭代
+  target.predict(0.01);
+  auto traj = reference(target.snapshot(), 22);
+  yaw_solver.set_x0(traj.block<2, 1>(0, 0));
+  yaw_solver.work.Xref = traj.topRows<2>();
+  yaw_solver.solve();
+  joint_solver->set_x0(auto_aim::YAW_LANE, traj.block<2, 1>(0, 0));
+  joint_solver->set_x_ref(auto_aim::YAW_LANE, traj.topRows<2>());
+  joint_solver->set_x_ref(auto_aim::PITCH_LANE, (traj.bottomRows<2>().array() + 1.0).matrix());
+  auto_aim::JointSolver::LaneMask active;
+  active << true, false;
+  joint_solver->begin(active);
+  joint_solver->iterate(joint_solver->settings.max_iter);
+  joint_solver->end();
+  const auto & yaw = joint_solver->solution[auto_aim::YAW_LANE];
+  auto masked_ok = yaw.iter == yaw_solver.work.iter &&
+                   (yaw.x - yaw_solver.work.x).cwiseAbs().maxCoeff() < 1e-6;
+  tools::logger()->info(
+    "masked: {} iter (yaw alone {} iter), {}", joint_solver->work.iter, yaw_solver.work.iter,
+    masked_ok ? "ok" : "mismatch");
+
+  tools::logger()->info(
+    "d={:.1f}m w={:.1f}rad/s sequential: {:.2f}us ({:.1f} iter), joint: {:.2f}us ({:.1f} iter)", d,
+    w, sequential_us / n, double(sequential_iter) / n, joint_us / n, double(joint_iter) / n);
+  tools::logger()->info("max state difference: {:.3e}, iter mismatch: {}", max_diff, iter_mismatch);
+
+  return (max_diff < 1e-6 && iter_mismatch == 0 && masked_ok) ? 0 : 1;
+}
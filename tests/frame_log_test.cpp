@@ -0,0 +1,192 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <vector>
+
+#include "tools/frame_log.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+
+const std::string keys =
+  "{help h usage ? |             | 输出命令行参数说明                   }"
+  "{dir d          | frame_log   | 录像目录，运行前会被清空             }"
+  "{n              | 1000        | 帧数                                 }"
+  "{fps            | 200         | 帧率，0表示尽快写入                  }"
+  "{width          | 1440        | 图像宽度                             }"
+  "{height         | 1080        | 图像高度                             }"
+  "{codec          | lz4         | raw, lz4或jpeg                       }"
+  "{quality        | 90          | JPEG质量                             }"
+  "{workers        | 2           | 压缩线程数                           }"
+  "{cpu-quota      | 1.0         | 压缩线程合计最多占用的CPU核数        }"
+  "{overflow       | newest      | 缓冲区满时丢弃newest、oldest或block  }"
+  "{ring           | 256         | 环形缓冲区大小(MB)                   }"
+  "{segment        | 256         | 单段大小上限(MB)                     }";
+
+using namespace tools::frame_log;
+
+// 合成图像：渐变背景 + 噪声 + 运动的亮斑，压缩率与真实相机图像接近
+cv::Mat synthetic(int i, int width, int height, const cv::Mat & noise)
+{
+  cv::Mat img(height, width, CV_8UC3);
+  for (int r = 0; r < height; r++) img.row(r).setTo(cv::Scalar(r * 255 / height, 40, 80));
+  img += noise;
+  cv::circle(img, {(i * 7) % width, height / 2}, 40, {255, 255, 255}, -1);
+  return img;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto dir = cli.get<std::string>("dir");
+  auto n = cli.get<int>("n");
+  auto fps = cli.get<double>("fps");
+  auto width = cli.get<int>("width");
+  auto height = cli.get<int>("height");
+  auto codec = cli.get<std::string>("codec");
+  auto overflow = cli.get<std::string>("overflow");
+
+  tools::FrameLogOptions options;
+  options.codec = codec == "raw" ? Codec::RAW : codec == "jpeg" ? Codec::JPEG : Codec::LZ4;
+  options.jpeg_quality = cli.get<int>("quality");
+  options.workers = cli.get<int>("workers");
+  options.cpu_quota = cli.get<double>("cpu-quota");
+  options.overflow = overflow == "block"    ? tools::Overflow::BLOCK
+                     : overflow == "oldest" ? tools::Overflow::DROP_OLDEST
+                                            : tools::Overflow::DROP_NEWEST;
+  options.ring_size = cli.get<std::size_t>("ring") << 20;
+  options.segment_size = cli.get<std::size_t>("segment") << 20;
+
+  std::filesystem::remove_all(dir);
+  std::filesystem::remove_all(dir + "_cut");
+
+  cv::Mat noise(height, width, CV_8UC3);
+  cv::randu(noise, 0, 8);
+  std::vector<cv::Mat> frames;
+  for (int i = 0; i < 16; i++) frames.push_back(synthetic(i, width, height, noise));
+
+  // JPEG有损，其余须逐像素一致
+  auto same = [&](const cv::Mat & img, int i) {
+    const auto & expected = frames[i % frames.size()];
+    if (img.size() != expected.size() || img.type() != expected.type()) return false;
+    if (options.codec == Codec::JPEG) return cv::PSNR(img, expected) > 30;
+    return cv::norm(img, expected, cv::NORM_INF) == 0;
+  };
+
+  // 1. 模拟相机线程按固定帧率写入，另一个线程写入IMU和旁路数据
+  tools::FrameLogWriter::Stats stats;
+  std::map<int64_t, int> written;  // 时间戳 -> 帧序号，DROP_OLDEST时其中的帧仍可能被丢弃
+  double max_write_us = 0, elapsed = 0;
+  {
+    tools::FrameLogWriter writer(dir, options);
+
+    std::atomic<bool> quit = false;
+    std::thread imu_thread([&] {
+      while (!quit) {
+        auto t = std::chrono::steady_clock::now();
+        writer.write_imu(Eigen::Quaterniond::Identity(), t);
+        uint8_t can[8] = {0x11, 0x22};
+        writer.write_side(0x100, can, sizeof(can), t);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+      if (fps > 0)
+        std::this_thread::sleep_until(start + std::chrono::microseconds(int(i * 1e6 / fps)));
+      auto t = std::chrono::steady_clock::now();
+      if (writer.write_frame(frames[i % frames.size()], t)) written[to_ns(t)] = i;
+      max_write_us = std::max(
+        max_write_us, tools::delta_time(std::chrono::steady_clock::now(), t) * 1e6);
+    }
+    elapsed = tools::delta_time(std::chrono::steady_clock::now(), start);
+
+    quit = true;
+    imu_thread.join();
+    stats = writer.stats();  // 不含析构时写完缓冲区剩余记录的部分
+  }
+
+  // 2. 逐段检查记录头，seq须单调递增
+  uint64_t frames_read = 0;
+  int64_t last_seq = -1;
+  bool format_ok = true;
+  uint32_t segments = 0;
+  for (; std::filesystem::exists(dir + "/" + segment_name(segments)); segments++) {
+    std::ifstream file(dir + "/" + segment_name(segments), std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), {});
+
+    SegmentHeader segment;
+    std::memcpy(&segment, data.data(), sizeof(segment));
+    if (std::memcmp(segment.magic, SEGMENT_MAGIC, 4) != 0 || segment.index != segments)
+      format_ok = false;
+
+    for (auto pos = sizeof(SegmentHeader); pos + sizeof(RecordHeader) <= data.size();) {
+      RecordHeader header;
+      std::memcpy(&header, data.data() + pos, sizeof(header));
+      if (header.magic != RECORD_MAGIC || int64_t(header.seq) <= last_seq) format_ok = false;
+      if (header.magic != RECORD_MAGIC) break;
+      last_seq = header.seq;
+      frames_read += header.type == RecordType::FRAME;
+      pos += sizeof(header) + aligned(header.size);
+    }
+  }
+
+  // 3. 按索引随机读取、按时间查找和截取
+  int reader_mismatches = 0, cut_mismatches = 0;
+  std::size_t cut_size = 0;
+  double seek_us = 0;
+  {
+    tools::FrameLogReader reader(dir);
+    if (reader.size() != frames_read || reader.size() < 4) {
+      tools::logger()->error("Index has {} of {} frames", reader.size(), frames_read);
+      return 1;
+    }
+
+    auto check = [&](tools::FrameLogReader & r, std::size_t i) {
+      tools::FrameLogReader::Frame frame;
+      if (!r.read(i, frame)) return false;
+      auto it = written.find(to_ns(frame.timestamp));
+      return it != written.end() && same(frame.img, it->second);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < reader.size(); k++) {
+      auto i = (k * 7919) % reader.size();
+      if (!check(reader, i) || reader.find(reader.timestamp(i)) != i) reader_mismatches++;
+    }
+    seek_us = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e6 / reader.size();
+
+    auto first = reader.size() / 4, last = reader.size() * 3 / 4;
+    auto [t_first, t_last] = reader.range(reader.timestamp(first), reader.timestamp(last));
+    if (t_first != first || t_last != last || !reader.cut(dir + "_cut", first, last)) {
+      tools::logger()->error("Failed to cut [{}, {})", first, last);
+      return 1;
+    }
+
+    tools::FrameLogReader cut(dir + "_cut");
+    cut_size = cut.size();
+    for (std::size_t i = 0; i < cut.size(); i++)
+      if (!check(cut, i) || cut.timestamp(i) != reader.timestamp(first + i)) cut_mismatches++;
+    if (cut_size != last - first) cut_mismatches++;
+  }
+
+  tools::logger()->info(
+    "{} frames in {:.2f}s ({:.0f}fps), {} written, {} dropped in total, write_frame max {:.0f}us",
+    n, elapsed, n / elapsed, frames_read, stats.dropped, max_write_us);
+  tools::logger()->info(
+    "{} segments, {}, compression cpu {:.2f}s ({:.0f}% of one core)", segments,
+    format_ok ? "format ok" : "bad format", stats.cpu_time, stats.cpu_time / elapsed * 100);
+  tools::logger()->info(
+    "reader: {} mismatches, {:.1f}us per random read; cut {} frames, {} mismatches",
+    reader_mismatches, seek_us, cut_size, cut_mismatches);
+
+  return (format_ok && reader_mismatches == 0 && cut_mismatches == 0) ? 0 : 1;
+}
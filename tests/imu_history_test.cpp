@@ -0,0 +1,77 @@
+#include <atomic>
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include <thread>
+
+#include "tools/imu_history.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+
+using namespace std::chrono_literals;
+
+const std::string keys =
+  "{help h usage ? |      | 输出命令行参数说明         }"
+  "{w              | 5.0  | 模拟云台yaw角速度(rad/s) }"
+  "{n              | 5000 | 写入样本数(1kHz)          }";
+
+// 写线程以1kHz写入绕z轴匀速转动的姿态，读线程查询过去和未来时刻的姿态并与真值比较
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto w = cli.get<double>("w");
+  auto n = cli.get<int>("n");
+
+  tools::ImuHistory<> history;
+  auto t0 = std::chrono::steady_clock::now();
+  auto truth = [&](std::chrono::steady_clock::time_point t) {
+    auto yaw = w * tools::delta_time(t, t0);
+    return Eigen::Quaterniond(Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()));
+  };
+
+  std::atomic<bool> quit = false;
+  auto writer = std::thread([&] {
+    for (int i = 0; i < n; i++) {
+      auto t = t0 + i * 1ms;
+      history.push(t, truth(t), {0, 0, w});
+      std::this_thread::sleep_until(t + 1ms);
+    }
+    quit = true;
+  });
+
+  double max_interp_error = 0, max_extrap_error = 0;
+  while (!quit) {
+    auto latest = history.latest();
+    if (!latest.has_value()) continue;
+
+    // 模拟视觉线程查询曝光时刻（过去）的姿态
+    auto past = latest->t - 3500us;
+    auto q = history.at(past);
+    if (q.has_value())
+      max_interp_error = std::max(max_interp_error, q->angularDistance(truth(past)));
+
+    // 模拟MPC线程查询略晚于最新样本的姿态
+    auto future = latest->t + 2ms;
+    q = history.at(future);
+    if (q.has_value())
+      max_extrap_error = std::max(max_extrap_error, q->angularDistance(truth(future)));
+
+    std::this_thread::sleep_for(100us);
+  }
+  writer.join();
+
+  auto stats = history.stats();
+  tools::logger()->info(
+    "lookups: {}, extrapolations: {}, misses: {}, retries: {}", stats.lookups,
+    stats.extrapolations, stats.misses, stats.retries);
+  tools::logger()->info(
+    "latency mean: {:.3f}us, max: {:.3f}us, last staleness: {:.2f}ms", stats.mean_latency_us,
+    stats.max_latency_us, stats.last_staleness_ms);
+  tools::logger()->info(
+    "max error interp: {:.3e}rad, extrap: {:.3e}rad", max_interp_error, max_extrap_error);
+
+  return (max_interp_error < 1e-6 && max_extrap_error < 1e-6) ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <opencv2/opencv.hpp>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "tools/latency_histogram.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+
+const std::string keys =
+  "{help h usage ? |        | 输出命令行参数说明     }"
+  "{threads        | 3      | 并发记录的线程数       }"
+  "{n              | 200000 | 每个线程记录的样本数   }";
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto threads = cli.get<int>("threads");
+  auto n = cli.get<int>("n");
+
+  // 1. 对数正态分布的延迟，与精确分位数比较
+  std::mt19937 rng(42);
+  std::lognormal_distribution<double> distribution(std::log(5e6), 0.5);  // 中位数5ms
+  std::vector<int64_t> samples(n);
+  for (auto & sample : samples) sample = static_cast<int64_t>(distribution(rng));
+
+  tools::LatencyHistogram histogram;
+  auto start = std::chrono::steady_clock::now();
+  for (auto sample : samples) histogram.record(sample);
+  auto record_ns = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e9 / n;
+
+  std::sort(samples.begin(), samples.end());
+  auto exact = [&](double p) { return double(samples[std::ceil(p * n) - 1]); };
+  auto s = histogram.summary();
+  auto max_error = 0.0;
+  for (auto [p, value] : {std::pair{0.5, s.p50}, {0.99, s.p99}, {0.999, s.p999}})
+    max_error = std::max(max_error, std::abs(value - exact(p)) / exact(p));
+
+  // 2. 多线程记录的同时周期性take()，样本不丢失
+  uint64_t taken = 0;
+  std::atomic<bool> done = false;
+  std::thread reader([&] {
+    while (!done) {
+      taken += histogram.take().count;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int i = 0; i < threads; i++)
+    writers.emplace_back([&] {
+      for (auto sample : samples) histogram.record(sample);
+    });
+  for (auto & writer : writers) writer.join();
+  done = true;
+  reader.join();
+  taken += histogram.take().count;
+  auto expected = uint64_t(n) * (threads + 1);
+
+  tools::logger()->info(
+    "p50 {:.3f}/{:.3f}ms p99 {:.3f}/{:.3f}ms p99.9 {:.3f}/{:.3f}ms max {:.3f}/{:.3f}ms",
+    s.p50 / 1e6, exact(0.5) / 1e6, s.p99 / 1e6, exact(0.99) / 1e6, s.p999 / 1e6,
+    exact(0.999) / 1e6, s.max / 1e6, samples.back() / 1e6);
+  tools::logger()->info(
+    "max relative error {:.2e}, record {:.1f}ns, {}/{} samples taken", max_error, record_ns, taken,
+    expected);
+
+  return max_error <= 1.0 / 128 && s.max == samples.back() && taken == expected ? 0 : 1;
+}
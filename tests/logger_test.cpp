@@ -0,0 +1,80 @@
+// 本文件中低于info的TOOLS_LOG_*宏展开为空
+#define TOOLS_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include <thread>
+
+#include "tools/latency_histogram.hpp"
+#include "tools/logger.hpp"
+
+const std::string keys =
+  "{help h usage ? |               | 输出命令行参数说明                 }"
+  "{n              | 20000         | 每种方式记录的日志条数             }"
+  "{period         | 50            | 两条日志之间的间隔(us)，模拟相机反复断连 }"
+  "{output o       | logs/flap.log | 同步与异步logger写入的文件          }";
+
+// 模拟相机断连时捕获线程的循环，统计每次写日志的耗时
+template <typename F>
+tools::LatencyHistogram::Summary flap(int n, int period, F && log)
+{
+  tools::LatencyHistogram histogram;
+  for (int i = 0; i < n; i++) {
+    auto start = std::chrono::steady_clock::now();
+    log(i);
+    histogram.record(std::chrono::steady_clock::now() - start);
+    std::this_thread::sleep_for(std::chrono::microseconds(period));
+  }
+  return histogram.summary();
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto n = cli.get<int>("n");
+  auto period = cli.get<int>("period");
+  auto output = cli.get<std::string>("output");
+
+  tools::logger()->info("Logging {} messages per method to {}", n, output);
+
+  // 1. 在调用线程中格式化并写入文件，每条都刷新
+  auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(output, true);
+  auto sync_logger = std::make_shared<spdlog::logger>("sync", sink);
+  sync_logger->flush_on(spdlog::level::warn);
+  auto sync = flap(n, period, [&](int i) {
+    sync_logger->warn("Failed to read {} USB camera ({})", "video0", i);
+  });
+
+  // 2. 与tools::logger()相同的异步队列，写入同一文件
+  auto async_logger = std::make_shared<spdlog::async_logger>(
+    "async", sink, spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+  auto async = flap(n, period, [&](int i) {
+    async_logger->warn("Failed to read {} USB camera ({})", "video0", i);
+  });
+  async_logger->flush();
+
+  // 3. tools::logger()加每秒1条的限流
+  auto limited = flap(n, period, [&](int i) {
+    TOOLS_LOG_WARN_LIMITED(1, "Failed to read {} USB camera ({})", "video0", i);
+  });
+
+  // 4. 编译期关闭的级别不求值参数
+  auto evaluated = 0;
+  TOOLS_LOG_DEBUG_LIMITED(1, "{}", ++evaluated);
+
+  for (auto [name, s] : {std::pair{"sync", sync}, {"async", async}, {"limited", limited}})
+    tools::logger()->info(
+      "{:>8}: mean {:.2f}us p50 {:.2f}us p99 {:.2f}us p99.9 {:.2f}us max {:.2f}us", name,
+      s.mean / 1e3, s.p50 / 1e3, s.p99 / 1e3, s.p999 / 1e3, s.max / 1e3);
+  tools::logger()->info("debug arguments evaluated: {}", evaluated);
+
+  // 异步队列的收益取决于后台线程能否在另一个核上运行，单核时不作要求
+  return limited.p99 < sync.p99 && evaluated == 0 ? 0 : 1;
+}
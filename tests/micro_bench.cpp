@@ -0,0 +1,448 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <opencv2/opencv.hpp>
+#include <queue>
+#include <string>
+#include <thread>
+
+#include "tasks/auto_aim/armor.hpp"
+#include "tasks/auto_aim/detector.hpp"
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tasks/auto_aim/planner/tiny_solver.hpp"
+#include "tasks/auto_aim/planner/tinympc/tiny_api.hpp"
+#include "tasks/auto_aim/target.hpp"
+#include "tests/allocation_counter.hpp"
+#include "tools/extended_kalman_filter.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/plotter.hpp"
+#include "tools/thread_safe_queue.hpp"
+#include "tools/trajectory.hpp"
+
+// 用法：micro_bench [--benchmark_*参数] [yaml配置文件路径]
+// 给出配置文件时才测试Detector::detect，因为需要加载分类器
+
+// 每个基准以"allocs"计数器给出每次迭代的分配次数，包括消费者线程中的分配
+class AllocationCounter
+{
+public:
+  explicit AllocationCounter(benchmark::State & state)
+  : state_(state), start_(allocation_counter::total)
+  {
+  }
+
+  ~AllocationCounter()
+  {
+    auto allocations = allocation_counter::total - start_;
+    state_.counters["allocs"] =
+      benchmark::Counter(double(allocations), benchmark::Counter::kAvgIterations);
+  }
+
+private:
+  benchmark::State & state_;
+  uint64_t start_;
+};
+
+using auto_aim::HORIZON;
+constexpr int TARGET_DIM = 11;  // x vx y vy z vz a w r l h
+constexpr int ARMOR_DIM = 4;    // yaw pitch distance angle
+
+// ---------------- EKF与Target ----------------
+
+void BM_EkfPredict(benchmark::State & state)
+{
+  Eigen::VectorXd x0 = Eigen::VectorXd::Ones(TARGET_DIM);
+  Eigen::MatrixXd P0 = Eigen::MatrixXd::Identity(TARGET_DIM, TARGET_DIM);
+  tools::ExtendedKalmanFilter ekf(x0, P0);
+  Eigen::MatrixXd F = Eigen::MatrixXd::Identity(TARGET_DIM, TARGET_DIM);
+  for (int i = 0; i < 6; i += 2) F(i, i + 1) = 0.01;
+  Eigen::MatrixXd Q = Eigen::MatrixXd::Identity(TARGET_DIM, TARGET_DIM) * 1e-3;
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ekf.predict(F, Q));
+    ekf.P = P0;
+  }
+}
+BENCHMARK(BM_EkfPredict);
+
+void BM_EkfUpdate(benchmark::State & state)
+{
+  Eigen::VectorXd x0 = Eigen::VectorXd::Ones(TARGET_DIM);
+  Eigen::MatrixXd P0 = Eigen::MatrixXd::Identity(TARGET_DIM, TARGET_DIM);
+  tools::ExtendedKalmanFilter ekf(x0, P0);
+  Eigen::MatrixXd H = Eigen::MatrixXd::Random(ARMOR_DIM, TARGET_DIM);
+  Eigen::MatrixXd R = Eigen::MatrixXd::Identity(ARMOR_DIM, ARMOR_DIM) * 1e-2;
+  Eigen::VectorXd z = H * x0;
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ekf.update(z, H, R));
+    ekf.x = x0;
+    ekf.P = P0;
+  }
+}
+BENCHMARK(BM_EkfUpdate);
+
+void BM_TargetPredict(benchmark::State & state)
+{
+  auto_aim::Target target(3.0, 5.0, 0.2, 0.1);
+  AllocationCounter counter(state);
+  for (auto _ : state) target.predict(0.01);
+}
+BENCHMARK(BM_TargetPredict);
+
+void BM_TargetArmorXyzaList(benchmark::State & state)
+{
+  auto_aim::Target target(3.0, 5.0, 0.2, 0.1);
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(target.armor_xyza_list());
+}
+BENCHMARK(BM_TargetArmorXyzaList);
+
+// ---------------- 弹道与坐标变换 ----------------
+
+void BM_Trajectory(benchmark::State & state)
+{
+  auto d = 1.0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tools::Trajectory(22, d, 0.3));
+    d = d > 8 ? 1.0 : d + 0.01;
+  }
+}
+BENCHMARK(BM_Trajectory);
+
+void BM_TrajectoryBatch(benchmark::State & state)
+{
+  std::array<double, HORIZON> d, h, pitch, fly_time;
+  for (int i = 0; i < HORIZON; i++) {
+    d[i] = 1.0 + 0.07 * i;
+    h[i] = 0.3;
+  }
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    tools::Trajectory::solve_batch(22, d.data(), h.data(), pitch.data(), fly_time.data(), HORIZON);
+    benchmark::DoNotOptimize(pitch.data());
+  }
+  state.SetItemsProcessed(state.iterations() * HORIZON);
+}
+BENCHMARK(BM_TrajectoryBatch);
+
+void BM_Eulers(benchmark::State & state)
+{
+  Eigen::Matrix3d R = tools::rotation_matrix({0.3, -0.2, 0.1});
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(tools::eulers(R, 2, 1, 0));
+}
+BENCHMARK(BM_Eulers);
+
+void BM_Xyz2ypd(benchmark::State & state)
+{
+  Eigen::Vector3d xyz{3.0, 0.5, 0.2};
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(tools::xyz2ypd(xyz));
+}
+BENCHMARK(BM_Xyz2ypd);
+
+void BM_Xyz2ypdJacobian(benchmark::State & state)
+{
+  Eigen::Vector3d xyz{3.0, 0.5, 0.2};
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(tools::xyz2ypd_jacobian(xyz));
+}
+BENCHMARK(BM_Xyz2ypdJacobian);
+
+void BM_Ypd2xyzJacobian(benchmark::State & state)
+{
+  Eigen::Vector3d ypd{0.2, 0.1, 3.0};
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(tools::ypd2xyz_jacobian(ypd));
+}
+BENCHMARK(BM_Ypd2xyzJacobian);
+
+// ---------------- MPC ----------------
+
+// 小陀螺时的yaw参考轨迹，与Planner的配置量级相同
+Eigen::Matrix<double, 2, HORIZON> reference(double w)
+{
+  Eigen::Matrix<double, 2, HORIZON> traj;
+  for (int i = 0; i < HORIZON; i++) {
+    auto a = tools::limit_rad(w * i * auto_aim::DT * 4) / 4;
+    traj.col(i) << 0.08 * std::sin(a), 0.08 * w * std::cos(a);
+  }
+  return traj;
+}
+
+// tinympc没有释放接口，求解器只建立一次，避免每次运行基准都泄漏
+TinySolver * tiny_solver()
+{
+  static TinySolver * solver = [] {
+    constexpr auto DT = auto_aim::DT;
+    Eigen::MatrixXd A{{1, DT}, {0, 1}}, B{{0}, {DT}}, f = Eigen::MatrixXd::Zero(2, 1);
+    Eigen::Vector2d Q{9e6, 0};
+    Eigen::Matrix<double, 1, 1> R{1.0};
+
+    TinySolver * solver;
+    tiny_setup(&solver, A, B, f, Q.asDiagonal(), R.asDiagonal(), 1.0, 2, 1, HORIZON, 0);
+    Eigen::MatrixXd x_min = Eigen::MatrixXd::Constant(2, HORIZON, -1e17);
+    Eigen::MatrixXd x_max = Eigen::MatrixXd::Constant(2, HORIZON, 1e17);
+    Eigen::MatrixXd u_min = Eigen::MatrixXd::Constant(1, HORIZON - 1, -50);
+    Eigen::MatrixXd u_max = Eigen::MatrixXd::Constant(1, HORIZON - 1, 50);
+    tiny_set_bound_constraints(solver, x_min, x_max, u_min, u_max);
+    solver->settings->max_iter = 10;
+    return solver;
+  }();
+  return solver;
+}
+
+void BM_TinySolve(benchmark::State & state)
+{
+  auto * solver = tiny_solver();
+  Eigen::MatrixXd traj = reference(8.0);
+  Eigen::VectorXd x0 = traj.col(0);
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    tiny_set_x0(solver, x0);
+    solver->work->Xref = traj;
+    tiny_solve(solver);
+  }
+}
+BENCHMARK(BM_TinySolve);
+
+void BM_FixedTinySolver(benchmark::State & state)
+{
+  constexpr auto DT = auto_aim::DT;
+  Eigen::Matrix2d A{{1, DT}, {0, 1}};
+  Eigen::Vector2d B{0, DT}, f{0, 0}, Q{9e6, 0};
+  Eigen::Matrix<double, 1, 1> R{1.0};
+
+  auto solver = std::make_unique<tinympc::TinySolver<2, 1, HORIZON>>();
+  solver->setup(A, B, f, Q, R, 1.0);
+  solver->set_input_bound(
+    Eigen::Matrix<double, 1, HORIZON - 1>::Constant(-50),
+    Eigen::Matrix<double, 1, HORIZON - 1>::Constant(50));
+  solver->settings.max_iter = 10;
+
+  auto traj = reference(8.0);
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    solver->set_x0(traj.col(0));
+    solver->work.Xref = traj;
+    solver->solve();
+  }
+}
+BENCHMARK(BM_FixedTinySolver);
+
+// ---------------- 检测 ----------------
+
+cv::RotatedRect lightbar_rect(float x) { return {{x, 500}, {12, 56}, 5}; }
+
+void BM_LightbarConstruction(benchmark::State & state)
+{
+  auto rect = lightbar_rect(600);
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(auto_aim::Lightbar(rect, 0));
+}
+BENCHMARK(BM_LightbarConstruction);
+
+void BM_ArmorConstruction(benchmark::State & state)
+{
+  auto_aim::Lightbar left(lightbar_rect(600), 0), right(lightbar_rect(730), 1);
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(auto_aim::Armor(left, right));
+}
+BENCHMARK(BM_ArmorConstruction);
+
+// 黑底上若干对蓝色灯条，每对中间为装甲板图案的位置
+cv::Mat synthetic_lightbars(int pairs)
+{
+  cv::Mat img(1024, 1280, CV_8UC3, cv::Scalar(0, 0, 0));
+  for (int i = 0; i < pairs; i++) {
+    auto x = 150.0f + i * 250.0f;
+    for (auto rect : {lightbar_rect(x), lightbar_rect(x + 130)}) {
+      cv::Point2f points[4];
+      rect.points(points);
+      std::vector<cv::Point> polygon(points, points + 4);
+      cv::fillConvexPoly(img, polygon, {255, 200, 120});
+    }
+    cv::putText(img, "3", {int(x) + 45, 530}, cv::FONT_HERSHEY_SIMPLEX, 2, {200, 200, 200}, 6);
+  }
+  return img;
+}
+
+void BM_DetectorDetect(benchmark::State & state, const std::string & config_path)
+{
+  auto_aim::Detector detector(config_path, false);
+  auto img = synthetic_lightbars(state.range(0));
+  AllocationCounter counter(state);
+  for (auto _ : state) benchmark::DoNotOptimize(detector.detect(img));
+}
+
+// ---------------- 队列 ----------------
+
+// 对照组：std::queue + 互斥锁，不带条件变量
+template <typename T>
+class MutexQueue
+{
+public:
+  void push(const T & value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push(value);
+  }
+
+  bool try_pop(T & value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) return false;
+    value = queue_.front();
+    queue_.pop();
+    return true;
+  }
+
+private:
+  std::mutex mutex_;
+  std::queue<T> queue_;
+};
+
+// 对照组：单生产者单消费者无锁环形队列
+template <typename T, std::size_t N = 1024>
+class SpscRing
+{
+public:
+  bool push(const T & value)
+  {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == N) return false;
+    data_[head % N] = value;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T & value)
+  {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) return false;
+    value = data_[tail % N];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::array<T, N> data_;
+  alignas(64) std::atomic<std::size_t> head_ = 0;
+  alignas(64) std::atomic<std::size_t> tail_ = 0;
+};
+
+// 同一线程内push再pop，只计锁和分配的开销
+void BM_ThreadSafeQueuePushPop(benchmark::State & state)
+{
+  tools::ThreadSafeQueue<int> queue(16);
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    queue.push(1);
+    benchmark::DoNotOptimize(queue.pop());
+  }
+}
+BENCHMARK(BM_ThreadSafeQueuePushPop);
+
+void BM_MutexQueuePushPop(benchmark::State & state)
+{
+  MutexQueue<int> queue;
+  int value;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    queue.push(1);
+    benchmark::DoNotOptimize(queue.try_pop(value));
+  }
+}
+BENCHMARK(BM_MutexQueuePushPop);
+
+void BM_SpscRingPushPop(benchmark::State & state)
+{
+  SpscRing<int> queue;
+  int value;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    queue.push(1);
+    benchmark::DoNotOptimize(queue.try_pop(value));
+  }
+}
+BENCHMARK(BM_SpscRingPushPop);
+
+// 本线程push，另一线程pop，统计每个元素的传递耗时
+// 满时不丢弃而是重试，与SpscRingHandoff一致，保证每个元素都被传递且结束标记不会丢失
+void BM_ThreadSafeQueueHandoff(benchmark::State & state)
+{
+  bool full = false;  // 只在本线程的push中被设置
+  tools::ThreadSafeQueue<int> queue(1024, [&] { full = true; });
+  auto push = [&](int value) {
+    do {
+      full = false;
+      queue.push(value);
+      if (full) std::this_thread::yield();
+    } while (full);
+  };
+  std::thread consumer([&] {
+    while (queue.pop() >= 0) {
+    }
+  });
+  AllocationCounter counter(state);
+  for (auto _ : state) push(1);
+  push(-1);
+  consumer.join();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThreadSafeQueueHandoff)->UseRealTime();
+
+void BM_SpscRingHandoff(benchmark::State & state)
+{
+  SpscRing<int> queue;
+  std::thread consumer([&] {
+    int value = 0;
+    while (value >= 0)
+      if (!queue.try_pop(value)) std::this_thread::yield();
+  });
+  AllocationCounter counter(state);
+  for (auto _ : state)
+    while (!queue.push(1)) std::this_thread::yield();
+  while (!queue.push(-1)) std::this_thread::yield();
+  consumer.join();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpscRingHandoff)->UseRealTime();
+
+// ---------------- 调试输出 ----------------
+
+void BM_PlotterPlot(benchmark::State & state)
+{
+  tools::Plotter plotter;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    nlohmann::json data;
+    for (int i = 0; i < state.range(0); i++) data["channel_" + std::to_string(i)] = i * 0.1;
+    plotter.plot(data);
+  }
+}
+BENCHMARK(BM_PlotterPlot)->Arg(20);
+
+int main(int argc, char * argv[])
+{
+  benchmark::Initialize(&argc, argv);
+  if (argc > 1) {
+    std::string config_path = argv[1];
+    benchmark::RegisterBenchmark("BM_DetectorDetect", BM_DetectorDetect, config_path)
+      ->Arg(1)
+      ->Arg(4);
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+#include "tasks/auto_aim/multi_tracker.hpp"
+#include "tasks/auto_aim/solver.hpp"
+#include "tasks/auto_aim/synthetic_scene.hpp"
+#include "tools/hungarian.hpp"
+#include "tools/logger.hpp"
+#include "tools/yaml.hpp"
+
+const std::string keys =
+  "{help h usage ? |                        | 输出命令行参数说明 }"
+  "{fps            | 100                    | 帧率 }"
+  "{distance       | 3                      | 旋转中心的距离(m) }"
+  "{jump           | -1.0                   | 第二阶段three的横向跳变(m)，应远超关联门限 }"
+  "{@config-path   | configs/sentry.yaml    | yaml配置文件的路径，需包含multi_tracker_*参数 }";
+
+// 由真值角点构造装甲板，跳过Detector，使关联结果只取决于MultiTracker
+std::list<auto_aim::Armor> to_armors(
+  const auto_aim::SyntheticFrame & frame, auto_aim::ArmorName skip = auto_aim::not_armor)
+{
+  std::list<auto_aim::Armor> armors;
+  for (const auto & truth : frame.armors) {
+    if (truth.name == skip) continue;
+    auto it = std::find(
+      auto_aim::armor_properties.begin(), auto_aim::armor_properties.end(),
+      std::make_tuple(truth.color, truth.name, truth.type));
+    int class_id = it - auto_aim::armor_properties.begin();
+    auto & armor =
+      armors.emplace_back(class_id, 1.0f, cv::boundingRect(truth.points), truth.points);
+    armor.priority = (truth.name == auto_aim::three) ? auto_aim::first : auto_aim::second;
+  }
+  return armors;
+}
+
+const auto_aim::MultiTracker::Track * find(
+  const auto_aim::MultiTracker & tracker, auto_aim::ArmorName name)
+{
+  for (const auto & track : tracker.tracks())
+    if (track.target.name == name) return &track;
+  return nullptr;
+}
+
+bool check(bool ok, const std::string & what)
+{
+  if (!ok) tools::logger()->error("FAILED: {}", what);
+  return ok;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto config_path = cli.get<std::string>(0);
+  auto fps = cli.get<double>("fps");
+  auto distance = cli.get<double>("distance");
+  auto jump = cli.get<double>("jump");
+
+  auto ok = true;
+
+  // 1. 指派：不可行的配对不被选中，行列数不等时多余的行为-1
+  Eigen::MatrixXd cost(3, 2);
+  cost << 1, 1e9, 1e9, 2, 0.5, 0.4;
+  auto assignment = tools::hungarian(cost, 1e9);
+  ok &= check(assignment == std::vector<int>({0, 1, -1}), "hungarian rectangular");
+  cost << 1e9, 1e9, 3, 1e9, 1e9, 1e9;
+  assignment = tools::hungarian(cost, 1e9);
+  ok &= check(assignment == std::vector<int>({-1, 0, -1}), "hungarian infeasible");
+
+  auto yaml = tools::load(config_path);
+  auto min_detect_count = tools::read<int>(yaml, "min_detect_count");
+  auto max_lost_count = tools::read<int>(yaml, "max_temp_lost_count");
+  auto color = tools::read<std::string>(yaml, "enemy_color") == "red" ? auto_aim::red
+                                                                       : auto_aim::blue;
+
+  // three和four静止并排，第二阶段three横向跳变，第三阶段four消失
+  auto_aim::SceneOptions options;
+  options.noise = 0;
+  options.blur_samples = 1;
+  options.follow = false;
+  auto_aim::SyntheticRobot three, four;
+  three.name = auto_aim::three;
+  four.name = auto_aim::four;
+  three.color = four.color = color;
+  three.xyz = {distance, 0.4, 0};
+  four.xyz = {distance, -0.4, 0};
+
+  auto_aim::SyntheticScene before(config_path, options), after(config_path, options);
+  before.add(three);
+  before.add(four);
+  three.xyz.y() += jump;
+  after.add(three);
+  after.add(four);
+
+  auto_aim::Solver solver(config_path);
+  auto_aim::MultiTracker tracker(config_path, solver);
+  auto frame_id = 0;
+  auto step = [&](const auto_aim::SyntheticScene & scene, auto_aim::ArmorName skip) {
+    auto frame = scene.render(frame_id++ / fps);
+    auto armors = to_armors(frame, skip);
+    solver.set_R_gimbal2world(frame.q);
+    return tracker.track(armors, frame.t);
+  };
+
+  // 2. 生命周期：新建、确认、选择优先级高的目标
+  std::list<auto_aim::Target> targets;
+  for (int i = 0; i < 2 * min_detect_count; i++) targets = step(before, auto_aim::not_armor);
+  auto three_track = find(tracker, auto_aim::three);
+  auto four_track = find(tracker, auto_aim::four);
+  ok &= check(tracker.tracks().size() == 2, "two tracks created");
+  ok &= check(three_track && four_track && three_track->id != four_track->id, "distinct ids");
+  ok &= check(
+    !targets.empty() && targets.front().name == auto_aim::three, "select higher priority");
+  auto three_id = three_track ? three_track->id : -1;
+
+  // 3. 门限：跳变后的观测不与原航迹关联，沿用id重新初始化，不产生重复航迹也不滑行
+  targets = step(after, auto_aim::not_armor);
+  three_track = find(tracker, auto_aim::three);
+  ok &= check(tracker.tracks().size() == 2, "no duplicate track after jump");
+  ok &= check(three_track && three_track->id == three_id, "track id kept after reinit");
+  ok &= check(
+    three_track && three_track->detect_count == 1 && three_track->lost_count == 0,
+    "track reinitialised instead of coasting");
+  ok &= check(
+    !targets.empty() && targets.front().name == auto_aim::four, "switch to confirmed track");
+
+  for (int i = 0; i < 2 * min_detect_count; i++) targets = step(after, auto_aim::not_armor);
+  three_track = find(tracker, auto_aim::three);
+  if (three_track) {
+    auto x = three_track->target.ekf_x();
+    auto error = std::hypot(x[0] - three.xyz.x(), x[2] - three.xyz.y());
+    tools::logger()->info("three center error after reinit: {:.3f}m", error);
+    ok &= check(error < 0.1, "reinitialised track converges");
+  }
+
+  // 4. 删除：连续丢失超过max_temp_lost_count帧后删除，选择回到剩余的航迹
+  for (int i = 0; i <= max_lost_count; i++) targets = step(after, auto_aim::four);
+  ok &= check(find(tracker, auto_aim::four) == nullptr, "lost track deleted");
+  ok &= check(
+    !targets.empty() && targets.front().name == auto_aim::three, "reselect after deletion");
+
+  tools::logger()->info("{} frames, {}", frame_id, ok ? "passed" : "failed");
+  return ok ? 0 : 1;
+}
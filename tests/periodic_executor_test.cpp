@@ -0,0 +1,70 @@
+#include <chrono>
+#include <opencv2/opencv.hpp>
+
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/periodic_executor.hpp"
+
+using namespace std::chrono_literals;
+
+const std::string keys =
+  "{help h usage ? |      | 输出命令行参数说明                 }"
+  "{period p       | 4.0  | 周期(ms)                         }"
+  "{work w         | 1.5  | 每周期任务耗时(ms)                }"
+  "{n              | 1000 | 运行周期数                        }"
+  "{overrun-every  | 100  | 每隔多少个周期让任务耗时2.5个周期 }"
+  "{priority       | 0    | SCHED_FIFO优先级，0表示不修改     }"
+  "{cpu            | -1   | 绑定的CPU编号，-1表示不绑定       }";
+
+// 忙等模拟求解耗时，不让出CPU
+void busy_wait(double ms)
+{
+  auto start = std::chrono::steady_clock::now();
+  while (tools::delta_time(std::chrono::steady_clock::now(), start) * 1e3 < ms) {
+  }
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto period = cli.get<double>("period");
+  auto work = cli.get<double>("work");
+  auto n = cli.get<int>("n");
+  auto overrun_every = cli.get<int>("overrun-every");
+
+  auto priority = cli.get<int>("priority");
+  auto cpu = cli.get<int>("cpu");
+
+  tools::PeriodicExecutor executor(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(period * 1ms), priority, cpu);
+
+  int i = 0;
+  auto start = std::chrono::steady_clock::now();
+  executor.run([&] {
+    i++;
+    busy_wait(overrun_every > 0 && i % overrun_every == 0 ? 2.5 * period : work);
+    if (i >= n) executor.stop();
+  });
+  auto elapsed = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e3;
+
+  auto stats = executor.stats();
+  tools::logger()->info("{}", executor.summary());
+
+  // 总耗时应为(周期数+跳过的周期数)个周期，不随任务耗时累积漂移
+  auto expected = (n + stats.skipped) * period;
+  tools::logger()->info("elapsed {:.1f}ms, expected {:.1f}ms", elapsed, expected);
+
+  // 调度噪声也可能造成overrun，只要求注入的overrun全部被统计到
+  uint64_t expected_overruns = overrun_every > 0 ? n / overrun_every : 0;
+  auto ok = stats.overruns >= expected_overruns && std::abs(elapsed - expected) < period;
+
+  // 无锁读取的值与stats()一致
+  ok = ok && executor.overruns() == stats.overruns &&
+       executor.last_period_us() == stats.last_period_us &&
+       executor.last_jitter_us() == stats.last_jitter_us;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+#include <fmt/core.h>
+#include <sys/resource.h>  // getrusage
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <vector>
+
+#include "tasks/auto_aim/aimer.hpp"
+#include "tasks/auto_aim/detector.hpp"
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tasks/auto_aim/solver.hpp"
+#include "tasks/auto_aim/tracker.hpp"
+#include "tasks/auto_aim/yolo.hpp"
+#include "tests/allocation_counter.hpp"
+#include "tools/frame_log.hpp"
+#include "tools/latency_histogram.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/thread_pool.hpp"
+
+const std::string keys =
+  "{help h usage ? |                   | 输出命令行参数说明 }"
+  "{config-path c  | configs/demo.yaml | yaml配置文件的路径 }"
+  "{detector d     | yolo              | yolo或traditional }"
+  "{threads        | 1                 | 检测线程数，大于1时多个检测器并行、按帧序号重排后跟踪 }"
+  "{aim            | aimer             | aimer或planner }"
+  "{bullet-speed   | 22                | 弹速(m/s)，录像不含弹速，应与下位机上报的一致 }"
+  "{max-frames n   | 0                 | 每段录像最多处理的帧数，0表示全部 }"
+  "{output o       | pipeline_bench    | 结果保存为<output>.json和<output>.csv }"
+  "{baseline b     |                   | 与之比较的基准结果(json)，为空时不比较 }"
+  "{tolerance      | 0.1               | 相对基准变差超过该比例时返回失败 }"
+  "{@input-path    | assets/records    | 录像目录，或包含多段录像的目录 }";
+
+enum Stage
+{
+  READ,
+  DETECT,
+  TRACK,
+  AIM,
+  STAGE_NUM
+};
+
+const char * STAGE_NAMES[STAGE_NUM] = {"read", "detect", "track", "aim"};
+
+struct StageStats
+{
+  tools::LatencyHistogram histogram;
+  std::atomic<uint64_t> allocations = 0;
+};
+
+std::array<StageStats, STAGE_NUM> stages;
+
+template <typename F>
+auto measure(Stage stage, F && f)
+{
+  // 各阶段可能在不同线程中同时测量，只统计本线程的分配
+  auto start_allocations = allocation_counter::local;
+  auto start = std::chrono::steady_clock::now();
+  auto result = f();
+  stages[stage].histogram.record(std::chrono::steady_clock::now() - start);
+  stages[stage].allocations += allocation_counter::local - start_allocations;
+  return result;
+}
+
+// 每个检测线程一个检测器，不共享状态
+class ArmorDetector
+{
+public:
+  ArmorDetector(const std::string & type, const std::string & config_path)
+  {
+    if (type == "traditional")
+      detector_ = std::make_unique<auto_aim::Detector>(config_path, false);
+    else
+      yolo_ = std::make_unique<auto_aim::YOLO>(config_path, false);
+  }
+
+  std::list<auto_aim::Armor> detect(const cv::Mat & img, int frame_count)
+  {
+    return yolo_ ? yolo_->detect(img, frame_count) : detector_->detect(img, frame_count);
+  }
+
+private:
+  std::unique_ptr<auto_aim::YOLO> yolo_;
+  std::unique_ptr<auto_aim::Detector> detector_;
+};
+
+// 输入为单段录像时返回其本身，否则返回其下各段录像
+std::vector<std::string> list_recordings(const std::string & input_path)
+{
+  namespace fs = std::filesystem;
+  if (fs::exists(fs::path(input_path) / tools::frame_log::segment_name(0))) return {input_path};
+
+  std::vector<std::string> recordings;
+  for (const auto & entry : fs::directory_iterator(input_path))
+    if (entry.is_directory() && fs::exists(entry.path() / tools::frame_log::segment_name(0)))
+      recordings.push_back(entry.path().string());
+  std::sort(recordings.begin(), recordings.end());
+  return recordings;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto input_path = cli.get<std::string>(0);
+  auto config_path = cli.get<std::string>("config-path");
+  auto detector_type = cli.get<std::string>("detector");
+  auto threads = std::max(1, cli.get<int>("threads"));
+  auto aim_type = cli.get<std::string>("aim");
+  auto bullet_speed = cli.get<double>("bullet-speed");
+  auto max_frames = cli.get<int>("max-frames");
+  auto output = cli.get<std::string>("output");
+  auto baseline_path = cli.get<std::string>("baseline");
+  auto tolerance = cli.get<double>("tolerance");
+
+  auto recordings = list_recordings(input_path);
+  if (recordings.empty()) {
+    tools::logger()->error("No recording found in {}", input_path);
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<ArmorDetector>> detectors;
+  for (int i = 0; i < threads; i++)
+    detectors.push_back(std::make_unique<ArmorDetector>(detector_type, config_path));
+
+  uint64_t frames = 0;
+  double seconds = 0;
+
+  for (const auto & recording : recordings) {
+    tools::FrameLogReader reader(recording);
+    auto n = max_frames > 0 ? std::min<std::size_t>(max_frames, reader.size()) : reader.size();
+
+    // 每段录像重新创建跟踪器和决策器，比赛之间互不影响
+    auto_aim::Solver solver(config_path);
+    auto_aim::Tracker tracker(config_path, solver);
+    auto_aim::Aimer aimer(config_path);
+    auto_aim::Planner planner(config_path);
+
+    std::mutex reader_mutex;
+    auto read_and_detect = [&](std::size_t i, ArmorDetector & detector) {
+      tools::Frame frame{int(i) + 1};  // OrderedQueue的帧序号从1开始
+      auto ok = measure(READ, [&] {
+        std::lock_guard<std::mutex> lock(reader_mutex);
+        tools::FrameLogReader::Frame recorded;
+        if (!reader.read(i, recorded)) return false;
+        frame.img = recorded.img.clone();  // 下一次read()后失效
+        frame.t = recorded.timestamp;
+        frame.q = recorded.q;
+        return true;
+      });
+      if (ok) frame.armors = measure(DETECT, [&] { return detector.detect(frame.img, int(i)); });
+      return frame;
+    };
+
+    auto track_and_aim = [&](tools::Frame frame) {
+      if (frame.img.empty()) return;
+      solver.set_R_gimbal2world(frame.q);
+      auto targets = measure(TRACK, [&] { return tracker.track(frame.armors, frame.t); });
+      measure(AIM, [&] {
+        if (aim_type == "planner")
+          return !targets.empty() &&
+                 planner.plan(targets.front().snapshot(), bullet_speed).control;
+        return aimer.aim(targets, frame.t, bullet_speed, false).control;
+      });
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    if (threads == 1) {
+      for (std::size_t i = 0; i < n; i++) track_and_aim(read_and_detect(i, *detectors[0]));
+    } else {
+      // 多个检测线程依次领取帧，跟踪和决策在本线程中按帧序号依次完成
+      tools::OrderedQueue queue;
+      std::atomic<std::size_t> next = 0;
+      std::vector<std::thread> workers;
+      for (auto & detector : detectors)
+        workers.emplace_back([&, detector = detector.get()] {
+          for (auto i = next++; i < n; i = next++) queue.enqueue(read_and_detect(i, *detector));
+        });
+      for (std::size_t i = 0; i < n; i++) track_and_aim(queue.dequeue());
+      for (auto & worker : workers) worker.join();
+    }
+
+    auto elapsed = tools::delta_time(std::chrono::steady_clock::now(), start);
+    tools::logger()->info("{}: {} frames in {:.2f}s", recording, n, elapsed);
+    frames += n;
+    seconds += elapsed;
+  }
+
+  // 汇总
+  rusage usage;
+  ::getrusage(RUSAGE_SELF, &usage);
+
+  nlohmann::json result;
+  result["config"] = {
+    {"detector", detector_type}, {"threads", threads}, {"aim", aim_type},
+    {"bullet_speed", bullet_speed}, {"config", config_path}};
+  result["recordings"] = recordings.size();
+  result["frames"] = frames;
+  result["fps"] = frames / seconds;
+  result["peak_rss_mb"] = usage.ru_maxrss / 1024.0;  // ru_maxrss的单位为KB
+  for (int i = 0; i < STAGE_NUM; i++) {
+    auto s = stages[i].histogram.summary();
+    result["stages"][STAGE_NAMES[i]] = {
+      {"mean_ms", s.mean / 1e6},
+      {"p99_ms", s.p99 / 1e6},
+      {"allocs_per_frame", double(stages[i].allocations) / std::max<uint64_t>(s.count, 1)}};
+    tools::logger()->info(
+      "{:>6}: mean {:.3f}ms p99 {:.3f}ms, {:.1f} allocs/frame", STAGE_NAMES[i], s.mean / 1e6,
+      s.p99 / 1e6, result["stages"][STAGE_NAMES[i]]["allocs_per_frame"].get<double>());
+  }
+  tools::logger()->info(
+    "{} frames, {:.1f}fps, peak RSS {:.1f}MB", frames, result["fps"].get<double>(),
+    result["peak_rss_mb"].get<double>());
+
+  // 扁平的CSV，每行一个指标，便于diff
+  std::ofstream(output + ".json") << result.dump(2) << '\n';
+  std::ofstream csv(output + ".csv");
+  csv << "metric,value\n";
+  for (const auto & [key, value] : result.flatten().items())
+    if (value.is_number()) csv << key << ',' << value << '\n';
+
+  if (baseline_path.empty()) return 0;
+
+  // 与基准比较，fps越大越好，其余指标越小越好
+  std::ifstream file(baseline_path);
+  if (!file) {
+    tools::logger()->error("Failed to open baseline {}", baseline_path);
+    return 1;
+  }
+  auto baseline = nlohmann::json::parse(file).flatten();
+  auto current = result.flatten();
+  auto regressions = 0;
+  for (const auto & [key, value] : baseline.items()) {
+    if (
+      !value.is_number() || !current.contains(key) || key.rfind("/config", 0) == 0 ||
+      key == "/frames" || key == "/recordings")
+      continue;
+    auto before = value.get<double>();
+    auto after = current[key].get<double>();
+    auto higher_is_better = key == "/fps";
+    auto worse = higher_is_better ? after < before * (1 - tolerance)
+                                  : after > before * (1 + tolerance) && after - before > 1e-3;
+    if (worse) regressions++;
+    tools::logger()->log(
+      worse ? spdlog::level::warn : spdlog::level::info, "{:<32} {:>10.3f} -> {:>10.3f} {}", key,
+      before, after, worse ? "REGRESSED" : "");
+  }
+  return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#ifndef TESTS__PLANNER_REFERENCE_HPP
+#define TESTS__PLANNER_REFERENCE_HPP
+
+#include <cmath>
+
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/trajectory.hpp"
+
+// 与Planner::get_trajectory相同的参考轨迹：yaw, yaw_vel, pitch, pitch_vel
+// tiny_solver_test和batch_solver_test共用，两者的求解结果才能相互比较
+inline auto_aim::Trajectory reference(const auto_aim::TargetSnapshot & target, double bullet_speed)
+{
+  using auto_aim::DT;
+  using auto_aim::HALF_HORIZON;
+  using auto_aim::HORIZON;
+
+  static auto_aim::ArmorsPrediction prediction;
+  target.predict_armors(-DT * (HALF_HORIZON + 1), DT, HORIZON + 2, prediction);
+
+  Eigen::Matrix<double, 2, HORIZON + 2> yaw_pitch;
+  for (int i = 0; i < HORIZON + 2; i++) {
+    int best = 0;
+    for (int id = 1; id < prediction.armor_num; id++)
+      if (
+        std::hypot(prediction.x(id, i), prediction.y(id, i)) <
+        std::hypot(prediction.x(best, i), prediction.y(best, i)))
+        best = id;
+    auto d = std::hypot(prediction.x(best, i), prediction.y(best, i));
+    auto bullet_traj = tools::Trajectory(bullet_speed, d, prediction.z(best, i));
+    yaw_pitch.col(i) << std::atan2(prediction.y(best, i), prediction.x(best, i)),
+      -bullet_traj.pitch;
+  }
+
+  auto_aim::Trajectory traj;
+  auto yaw0 = yaw_pitch(0, HALF_HORIZON + 1);
+  for (int i = 0; i < HORIZON; i++) {
+    traj.col(i) << tools::limit_rad(yaw_pitch(0, i + 1) - yaw0),
+      tools::limit_rad(yaw_pitch(0, i + 2) - yaw_pitch(0, i)) / (2 * DT), yaw_pitch(1, i + 1),
+      (yaw_pitch(1, i + 2) - yaw_pitch(1, i)) / (2 * DT);
+  }
+  return traj;
+}
+
+#endif  // TESTS__PLANNER_REFERENCE_HPP
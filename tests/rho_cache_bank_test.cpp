@@ -0,0 +1,156 @@
+#include <chrono>
+#include <cmath>
+#include <opencv2/opencv.hpp>
+
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tasks/auto_aim/planner/rho_cache_bank.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+
+const std::string keys =
+  "{help h usage ? |      | 输出命令行参数说明                       }"
+  "{q              | 9e6  | 角度误差权重                             }"
+  "{r              | 1.0  | 角加速度权重                             }"
+  "{max-acc        | 50   | 最大角加速度(rad/s^2)                    }"
+  "{w              | 8.0  | 整车角速度(rad/s)，装甲板切换时参考轨迹跳变 }"
+  "{n              | 2000 | 规划次数                                 }"
+  "{max-iter       | 10   | 每次规划的最大迭代次数                   }"
+  "{tolerance      | 5.0  | 原始残差与对偶残差相差超过该倍数时调整rho  }"
+  "{output o       |      | 保存缓存库的路径，为空时不保存           }";
+
+using auto_aim::DT;
+using auto_aim::HORIZON;
+using Problem = auto_aim::StaticSolver;
+using Bank = tinympc::RhoCacheBank<Problem>;
+
+// 小陀螺：4块装甲板依次转入视野，yaw参考呈锯齿状
+Eigen::Matrix<double, 2, HORIZON> reference(double t, double w)
+{
+  Eigen::Matrix<double, 2, HORIZON> traj;
+  for (int i = 0; i < HORIZON; i++) {
+    auto a = tools::limit_rad(w * (t + i * DT) * 4) / 4;
+    traj.col(i) << 0.08 * std::sin(a), 0.08 * w * std::cos(a);
+  }
+  return traj;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto q = cli.get<double>("q");
+  auto r = cli.get<double>("r");
+  auto max_acc = cli.get<double>("max-acc");
+  auto w = cli.get<double>("w");
+  auto n = cli.get<int>("n");
+  auto max_iter = cli.get<int>("max-iter");
+  auto tolerance = cli.get<double>("tolerance");
+  auto output = cli.get<std::string>("output");
+
+  Problem::StateMatrix A{{1, DT}, {0, 1}};
+  Problem::InputMatrix B{0, DT};
+  Problem::StateVector f{0, 0};
+  Problem::StateVector Q{q, 0};
+  Problem::InputVector R{r};
+
+  // 1. 建库、读写
+  auto start = std::chrono::steady_clock::now();
+  Bank bank(A, B, f, Q, R);
+  auto build_ms = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e3;
+
+  if (!output.empty()) {
+    bank.save(output);
+    auto loaded = Bank::load(output, A, B, f, Q, R);
+    if (!loaded || loaded->at(bank.size() / 2).Kinf != bank.at(bank.size() / 2).Kinf) {
+      tools::logger()->error("Failed to reload {}", output);
+      return 1;
+    }
+  }
+
+  // 2. 网格点之间插值的相对误差
+  auto max_interp_error = 0.0;
+  for (int i = 0; i + 1 < bank.size(); i++) {
+    auto rho = std::sqrt(bank.rho(i) * bank.rho(i + 1));
+    auto exact = Problem::compute_cache(A, B, f, Q, R, rho);
+    auto interp = bank.lookup(rho);
+    auto error = (interp.Kinf - exact.Kinf).norm() / exact.Kinf.norm();
+    max_interp_error = std::max(max_interp_error, error);
+  }
+
+  // 3. 查找一次缓存与在线Riccati迭代的耗时
+  constexpr int REPEAT = 10000;
+  auto sink = 0.0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < REPEAT; i++) sink += bank.at(bank.index(0.5 + i % 100)).Kinf(0);
+  auto lookup_ns = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e9 / REPEAT;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100; i++) sink += Problem::compute_cache(A, B, f, Q, R, 0.5 + i).Kinf(0);
+  auto riccati_us = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e6 / 100;
+
+  // 4. 滚动时域规划：固定rho与残差平衡调整rho比较
+  auto fixed = std::make_unique<auto_aim::JointSolver>();
+  auto adaptive = std::make_unique<auto_aim::JointSolver>();
+  Problem problem;
+  problem.setup(A, B, f, Q, R, 1.0);
+  problem.set_input_bound(
+    Problem::InputTrajectory::Constant(-max_acc), Problem::InputTrajectory::Constant(max_acc));
+  for (auto * solver : {fixed.get(), adaptive.get()}) {
+    solver->setup(0, problem);
+    solver->setup(1, problem);
+    solver->settings.max_iter = max_iter;
+  }
+
+  int fixed_solved = 0, adaptive_solved = 0, fixed_iter = 0, adaptive_iter = 0, switches = 0;
+  double max_diff = 0;
+  for (int k = 0; k < n; k++) {
+    auto traj = reference(k * DT, w);
+    for (auto * solver : {fixed.get(), adaptive.get()})
+      for (int lane = 0; lane < 2; lane++) {
+        solver->set_x0(lane, traj.col(0));
+        solver->set_x_ref(lane, traj);
+      }
+
+    fixed->solve();
+
+    // 与Planner相同，每2次迭代检查一次残差
+    adaptive->begin();
+    for (int iter = 0; iter < max_iter; iter += 2) {
+      if (adaptive->iterate(std::min(2, max_iter - iter))) break;
+      for (int lane = 0; lane < 2; lane++) {
+        const auto & work = adaptive->work;
+        auto i = bank.select(
+          adaptive->cache.rho(lane),
+          std::max(work.primal_residual_state(lane), work.primal_residual_input(lane)),
+          std::max(work.dual_residual_state(lane), work.dual_residual_input(lane)), tolerance);
+        if (i < 0) continue;
+        adaptive->set_cache(lane, bank.at(i));
+        switches++;
+      }
+    }
+    adaptive->end();
+
+    fixed_solved += fixed->solution[0].solved;
+    adaptive_solved += adaptive->solution[0].solved;
+    fixed_iter += fixed->solution[0].iter;
+    adaptive_iter += adaptive->solution[0].iter;
+    auto diff = fixed->solution[0].x.row(0) - adaptive->solution[0].x.row(0);
+    max_diff = std::max(max_diff, diff.cwiseAbs().maxCoeff());
+  }
+
+  tools::logger()->info(
+    "{} caches on [{:.0e}, {:.0e}] built in {:.2f}ms, interpolation error max {:.2e}", bank.size(),
+    bank.rho(0), bank.rho(bank.size() - 1), build_ms, max_interp_error);
+  tools::logger()->info(
+    "bank lookup {:.1f}ns, online Riccati {:.1f}us ({:.0f})", lookup_ns, riccati_us, sink);
+  tools::logger()->info(
+    "fixed rho: {}/{} solved, {:.2f} iter; adaptive: {}/{} solved, {:.2f} iter, rho {:.3g}, "
+    "{} switches",
+    fixed_solved, n, double(fixed_iter) / n, adaptive_solved, n, double(adaptive_iter) / n,
+    adaptive->cache.rho(0), switches);
+  tools::logger()->info("max yaw difference {:.2e}rad", max_diff);
+
+  return max_interp_error < 1e-2 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <nlohmann/json.hpp>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+#include "tasks/auto_aim/detector.hpp"
+#include "tasks/auto_aim/solver.hpp"
+#include "tasks/auto_aim/synthetic_scene.hpp"
+#include "tasks/auto_aim/tracker.hpp"
+#include "tools/frame_log.hpp"
+#include "tools/latency_histogram.hpp"
+#include "tools/logger.hpp"
+#include "tools/yaml.hpp"
+
+const std::string keys =
+  "{help h usage ? |                        | 输出命令行参数说明 }"
+  "{dir d          | synthetic              | 录像目录，须为空或由本程序生成，会被清空 }"
+  "{n              | 1000                   | 帧数 }"
+  "{fps            | 100                    | 帧率 }"
+  "{distance       | 5                      | 旋转中心的距离(m) }"
+  "{w              | 6                      | 自转角速度(rad/s) }"
+  "{vy             | 0.3                    | 横向平移速度(m/s) }"
+  "{exposure       | 0                      | 曝光时间(ms)，0表示使用配置文件中的exposure_ms }"
+  "{noise          | 2                      | 高斯噪声的标准差(灰度) }"
+  "{blur           | 4                      | 曝光时间内的采样次数，1表示无运动模糊 }"
+  "{defocus        | 0.7                    | 失焦模糊的标准差(px) }"
+  "{imu-noise      | 0.001                  | IMU姿态噪声每轴的标准差(rad) }"
+  "{seed           | 0                      | 随机种子 }"
+  "{codec          | lz4                    | raw, lz4或jpeg }"
+  "{evaluate e     | false                  | 读回录像，统计Detector和Tracker相对真值的误差 }"
+  "{min-recall     | 0.9                    | 召回率低于该值时返回失败 }"
+  "{max-error      | 0.1                    | 跟踪的旋转中心误差(m)大于该值时返回失败 }"
+  "{@config-path   | configs/standard3.yaml | yaml配置文件的路径 }";
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto config_path = cli.get<std::string>(0);
+  auto dir = cli.get<std::string>("dir");
+  auto n = cli.get<int>("n");
+  auto fps = cli.get<double>("fps");
+  auto codec = cli.get<std::string>("codec");
+
+  auto yaml = tools::load(config_path);
+  auto_aim::SceneOptions options;
+  options.exposure_ms = cli.get<double>("exposure");
+  if (options.exposure_ms <= 0) options.exposure_ms = tools::read<double>(yaml, "exposure_ms");
+  options.noise = cli.get<double>("noise");
+  options.blur_samples = cli.get<int>("blur");
+  options.defocus = cli.get<double>("defocus");
+  options.imu_noise = cli.get<double>("imu-noise");
+  options.seed = cli.get<uint64_t>("seed");
+
+  // 敌方颜色的步兵，第1、3块装甲板更远、更高
+  auto_aim::SyntheticRobot robot;
+  robot.color = tools::read<std::string>(yaml, "enemy_color") == "red" ? auto_aim::red
+                                                                       : auto_aim::blue;
+  robot.xyz = {cli.get<double>("distance"), 0, 0};
+  robot.v = {0, cli.get<double>("vy"), 0};
+  robot.w = cli.get<double>("w");
+  robot.l = 0.03;
+  robot.h = 0.02;
+
+  auto_aim::SyntheticScene scene(config_path, options);
+  scene.add(robot);
+
+  // 1. 生成录像，BLOCK保证不丢帧
+  // 只清空本程序生成过的目录，防止误删传错的路径
+  if (
+    std::filesystem::exists(dir) && !std::filesystem::is_empty(dir) &&
+    !std::filesystem::exists(dir + "/truth.jsonl")) {
+    tools::logger()->error("{} is not empty and has no truth.jsonl, refusing to clear it", dir);
+    return 1;
+  }
+  std::filesystem::remove_all(dir);
+  tools::FrameLogOptions log_options;
+  log_options.codec = codec == "raw"    ? tools::frame_log::Codec::RAW
+                      : codec == "jpeg" ? tools::frame_log::Codec::JPEG
+                                        : tools::frame_log::Codec::LZ4;
+  log_options.overflow = tools::Overflow::BLOCK;
+  {
+    tools::FrameLogWriter writer(dir, log_options);
+    std::ofstream truth(dir + "/truth.jsonl");
+    for (int i = 0; i < n; i++) {
+      auto frame = scene.render(i / fps);
+      writer.write_imu(frame.q, frame.t);
+      writer.write_frame(frame.img, frame.t);
+      auto json = frame.truth();
+      json["frame"] = i;
+      truth << json.dump() << '\n';
+    }
+  }
+  tools::logger()->info("{} frames written to {}", n, dir);
+
+  if (!cli.get<bool>("evaluate")) return 0;
+
+  // 2. 读回录像，检测结果按中心就近与真值匹配
+  tools::FrameLogReader reader(dir);
+  std::ifstream truth_file(dir + "/truth.jsonl");
+  auto_aim::Detector detector(config_path, false);
+  auto_aim::Solver solver(config_path);
+  auto_aim::Tracker tracker(config_path, solver);
+  tools::LatencyHistogram detect_latency;
+
+  int truths = 0, matched = 0, false_positives = 0, tracked = 0;
+  double corner_error = 0, center_error = 0, w_error = 0;
+  std::string line;
+  for (std::size_t i = 0; i < reader.size() && std::getline(truth_file, line); i++) {
+    tools::FrameLogReader::Frame frame;
+    if (!reader.read(i, frame)) return 1;
+    auto truth = nlohmann::json::parse(line);
+
+    auto start = std::chrono::steady_clock::now();
+    auto armors = detector.detect(frame.img, i);
+    detect_latency.record(std::chrono::steady_clock::now() - start);
+
+    std::vector<bool> used(armors.size(), false);
+    for (const auto & expected : truth["armors"]) {
+      truths++;
+      std::vector<cv::Point2f> points;
+      for (const auto & p : expected["points"])
+        points.emplace_back(p[0].get<float>(), p[1].get<float>());
+      auto center = (points[0] + points[1] + points[2] + points[3]) / 4;
+
+      auto best = -1;
+      auto best_distance = 20.0;  // px
+      auto k = 0;
+      for (const auto & armor : armors) {
+        auto distance = cv::norm(armor.center - center);
+        if (!used[k] && distance < best_distance) {
+          best = k;
+          best_distance = distance;
+        }
+        k++;
+      }
+      if (best < 0) continue;
+
+      used[best] = true;
+      matched++;
+      const auto & armor = *std::next(armors.begin(), best);
+      for (int j = 0; j < 4; j++) corner_error += cv::norm(armor.points[j] - points[j]) / 4;
+    }
+    false_positives += std::count(used.begin(), used.end(), false);
+
+    // 前20%的帧用于收敛，不计入跟踪误差
+    solver.set_R_gimbal2world(frame.q);
+    auto targets = tracker.track(armors, frame.timestamp);
+    if (targets.empty() || i < reader.size() / 5) continue;
+    auto x = targets.front().ekf_x();
+    auto expected = truth["robots"][0];
+    tracked++;
+    center_error += std::hypot(x[0] - expected[0].get<double>(), x[2] - expected[2].get<double>());
+    w_error += std::abs(x[7] - expected[7].get<double>());
+  }
+
+  auto recall = double(matched) / std::max(truths, 1);
+  center_error /= std::max(tracked, 1);
+  auto s = detect_latency.summary();
+  tools::logger()->info(
+    "detector: recall {:.3f} ({}/{}), {} false positives, corner error {:.2f}px, "
+    "mean {:.2f}ms p99 {:.2f}ms",
+    recall, matched, truths, false_positives, corner_error / std::max(matched, 1), s.mean / 1e6,
+    s.p99 / 1e6);
+  tools::logger()->info(
+    "tracker: {} frames, center error {:.3f}m, w error {:.3f}rad/s", tracked, center_error,
+    w_error / std::max(tracked, 1));
+
+  auto ok = recall >= cli.get<double>("min-recall") && tracked > 0 &&
+            center_error <= cli.get<double>("max-error");
+  return ok ? 0 : 1;
+}
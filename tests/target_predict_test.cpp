@@ -0,0 +1,71 @@
+#include <chrono>
+#include <opencv2/opencv.hpp>
+
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tasks/auto_aim/target.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+
+const std::string keys =
+  "{help h usage ? |      | 输出命令行参数说明    }"
+  "{d              | 3.0  | Target距离(m)       }"
+  "{w              | 5.0  | Target角速度(rad/s) }"
+  "{n              | 1000 | 重复次数             }";
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto d = cli.get<double>("d");
+  auto w = cli.get<double>("w");
+  auto n = cli.get<int>("n");
+
+  auto_aim::Target target(d, w, 0.2, 0.1);
+  auto t0 = -auto_aim::DT * auto_aim::HALF_HORIZON;
+
+  // 现有做法：逐步调用EKF predict并重建armor_xyza_list
+  std::vector<std::vector<Eigen::Vector4d>> loop_result(auto_aim::HORIZON);
+  auto loop_start = std::chrono::steady_clock::now();
+  for (int k = 0; k < n; k++) {
+    auto copy = target;
+    copy.predict(t0);
+    for (int i = 0; i < auto_aim::HORIZON; i++) {
+      loop_result[i] = copy.armor_xyza_list();
+      copy.predict(auto_aim::DT);
+    }
+  }
+  auto loop_end = std::chrono::steady_clock::now();
+
+  // 解析预测
+  auto_aim::ArmorsPrediction prediction;
+  auto analytic_start = std::chrono::steady_clock::now();
+  for (int k = 0; k < n; k++) {
+    target.predict_armors(t0, auto_aim::DT, auto_aim::HORIZON, prediction);
+  }
+  auto analytic_end = std::chrono::steady_clock::now();
+
+  // 两种方法的最大误差
+  double max_xyz_error = 0, max_a_error = 0;
+  for (int i = 0; i < auto_aim::HORIZON; i++) {
+    for (int id = 0; id < prediction.armor_num; id++) {
+      const auto & xyza = loop_result[i][id];
+      Eigen::Vector3d xyz{prediction.x(id, i), prediction.y(id, i), prediction.z(id, i)};
+      max_xyz_error = std::max(max_xyz_error, (xyz - xyza.head<3>()).norm());
+      max_a_error =
+        std::max(max_a_error, std::abs(tools::limit_rad(prediction.a(id, i) - xyza[3])));
+    }
+  }
+
+  auto loop_us = tools::delta_time(loop_end, loop_start) * 1e6 / n;
+  auto analytic_us = tools::delta_time(analytic_end, analytic_start) * 1e6 / n;
+  tools::logger()->info(
+    "horizon={} loop: {:.2f}us, analytic: {:.2f}us, speedup: {:.1f}x", auto_aim::HORIZON, loop_us,
+    analytic_us, loop_us / analytic_us);
+  tools::logger()->info(
+    "max xyz error: {:.3e}m, max angle error: {:.3e}rad", max_xyz_error, max_a_error);
+
+  return (max_xyz_error < 1e-6 && max_a_error < 1e-6) ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#include <arpa/inet.h>   // htons
+#include <sys/socket.h>  // socket, bind, recv
+#include <unistd.h>      // close
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+#include "tools/exiter.hpp"
+#include "tools/logger.hpp"
+#include "tools/plotter.hpp"
+#include "tools/telemetry.hpp"
+
+const std::string keys =
+  "{help h usage ? |           | 输出命令行参数说明                         }"
+  "{port p         | 9871      | 接收遥测数据报的UDP端口                    }"
+  "{input i        |           | 遥测文件，非空时从文件读取而不是UDP接收    }"
+  "{host           | 127.0.0.1 | 转发JSON的目标地址                         }"
+  "{plot-port      | 9870      | 转发JSON的目标端口，与Plotter默认端口相同  }"
+  "{print          | false     | 同时把JSON逐行输出到标准输出               }";
+
+// 把二进制遥测解码为JSON，转发给原有的绘图工具
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto port = cli.get<int>("port");
+  auto input = cli.get<std::string>("input");
+  auto print = cli.get<bool>("print");
+
+  tools::Plotter plotter(cli.get<std::string>("host"), cli.get<int>("plot-port"));
+  tools::TelemetryDecoder decoder;
+  uint64_t datagrams = 0, objects = 0;
+
+  auto emit = [&](const std::vector<nlohmann::json> & jsons) {
+    for (const auto & json : jsons) {
+      plotter.plot(json);
+      if (print) std::cout << json.dump() << '\n';
+      objects++;
+    }
+  };
+
+  if (!input.empty()) {
+    std::ifstream file(input, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), {});
+    tools::telemetry::DatagramHeader header;
+    for (std::size_t pos = 0; pos + sizeof(header) <= data.size(); pos += header.size) {
+      std::memcpy(&header, data.data() + pos, sizeof(header));
+      if (header.magic != tools::telemetry::MAGIC || header.size < sizeof(header)) {
+        tools::logger()->error("Bad datagram at {} in {}", pos, input);
+        return 1;
+      }
+      datagrams++;
+      emit(decoder.decode(data.data() + pos, header.size));
+    }
+  } else {
+    tools::Exiter exiter;
+
+    auto sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = ::htons(port);
+    address.sin_addr.s_addr = INADDR_ANY;
+    if (::bind(sock, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+      tools::logger()->error("Failed to bind UDP port {}", port);
+      return 1;
+    }
+
+    // 超时返回，以便响应退出
+    timeval timeout{0, 100000};
+    ::setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::vector<char> buffer(65536);
+    while (!exiter.exit()) {
+      auto n = ::recv(sock, buffer.data(), buffer.size(), 0);
+      if (n <= 0) continue;
+      datagrams++;
+      emit(decoder.decode(buffer.data(), n));
+    }
+    ::close(sock);
+  }
+
+  emit(decoder.flush());
+
+  tools::logger()->info(
+    "{} datagrams, {} json, {} datagrams lost, {} samples dropped by sender", datagrams, objects,
+    decoder.lost(), decoder.dropped());
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <vector>
+
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/plotter.hpp"
+#include "tools/telemetry.hpp"
+
+const std::string keys =
+  "{help h usage ? |               | 输出命令行参数说明               }"
+  "{threads        | 3             | 记录线程数                       }"
+  "{n              | 20000         | 每个线程记录的次数               }"
+  "{period         | 250           | 每次记录之间的间隔(us)，0表示连续 }"
+  "{channels       | 20            | 每次记录的通道数                 }"
+  "{output o       | telemetry.bin | 遥测文件                         }";
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto threads = cli.get<int>("threads");
+  auto n = cli.get<int>("n");
+  auto period = cli.get<int>("period");
+  auto channels = cli.get<int>("channels");
+  auto output = cli.get<std::string>("output");
+
+  // 1. 每次记录channels个通道，比较Telemetry::record与Plotter::plot的耗时
+  std::vector<double> record_ns(threads);
+  tools::Telemetry::Stats stats;
+  {
+    tools::Telemetry telemetry("127.0.0.1", 9871, output);
+    std::vector<tools::Telemetry::Channel> ids;
+    for (int c = 0; c < channels; c++) ids.push_back(telemetry.channel(fmt::format("ch{}", c)));
+
+    std::vector<std::thread> workers;
+    for (int k = 0; k < threads; k++)
+      workers.emplace_back([&, k] {
+        double total = 0;
+        for (int i = 0; i < n; i++) {
+          auto t = std::chrono::steady_clock::now();
+          for (int c = 0; c < channels; c++) telemetry.record(ids[c], k * 1e6 + i + c * 1e-3, t);
+          total += tools::delta_time(std::chrono::steady_clock::now(), t);
+          if (period > 0) std::this_thread::sleep_for(std::chrono::microseconds(period));
+        }
+        record_ns[k] = total * 1e9 / n;
+      });
+    for (auto & worker : workers) worker.join();
+    stats = telemetry.stats();
+  }
+
+  tools::Plotter plotter;
+  auto plot_start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 1000; i++) {
+    nlohmann::json data;
+    for (int c = 0; c < channels; c++) data[fmt::format("ch{}", c)] = i + c * 1e-3;
+    plotter.plot(data);
+  }
+  auto plot_ns = tools::delta_time(std::chrono::steady_clock::now(), plot_start) * 1e9 / 1000;
+
+  // 2. 解码文件，每次记录应还原为一个完整的JSON对象
+  std::ifstream file(output, std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(file)), {});
+  tools::TelemetryDecoder decoder;
+  uint64_t datagrams = 0, objects = 0, partial = 0, bad = 0, unordered = 0;
+  double last_t = 0;
+  auto check = [&](const nlohmann::json & json) {
+    objects++;
+    if (json.size() != std::size_t(channels) + 1) partial++;  // 含"t"
+    if (json["t"].get<double>() < last_t) unordered++;  // 多个线程的样本应按时间归并
+    last_t = json["t"].get<double>();
+  };
+  tools::telemetry::DatagramHeader header;
+  for (std::size_t pos = 0; pos + sizeof(header) <= data.size(); pos += header.size) {
+    std::memcpy(&header, data.data() + pos, sizeof(header));
+    if (header.magic != tools::telemetry::MAGIC || header.size < sizeof(header)) {
+      bad++;
+      break;
+    }
+    datagrams++;
+    for (const auto & json : decoder.decode(data.data() + pos, header.size)) check(json);
+  }
+  for (const auto & json : decoder.flush()) check(json);
+
+  auto expected = uint64_t(threads) * n;
+  auto mean_record_ns = 0.0;
+  for (auto ns : record_ns) mean_record_ns += ns / threads;
+  tools::logger()->info(
+    "record {} channels: {:.0f}ns, Plotter::plot {:.0f}ns", channels, mean_record_ns, plot_ns);
+  tools::logger()->info(
+    "{} samples in {} datagrams ({:.1f}KB), {} dropped", stats.samples, stats.datagrams,
+    stats.bytes / 1e3, stats.dropped);
+  tools::logger()->info(
+    "decoded {}/{} objects from {} datagrams, {} partial, {} bad, {} unordered, {} lost", objects,
+    expected, datagrams, partial, bad, unordered, decoder.lost());
+
+  // 有丢弃时只检查格式
+  if (bad > 0 || unordered > 0) return 1;
+  return (decoder.dropped() > 0 || (objects == expected && partial == 0)) ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <opencv2/opencv.hpp>
+
+#include "tasks/auto_aim/planner/planner.hpp"
+#include "tasks/auto_aim/planner/static_solver.hpp"
+#include "tasks/auto_aim/planner/tiny_solver.hpp"
+#include "tasks/auto_aim/planner/tinympc/tiny_api.hpp"
+#include "tests/planner_reference.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/trajectory.hpp"
+#include "tools/yaml.hpp"
+
+const std::string keys =
+  "{help h usage ? |      | 输出命令行参数说明    }"
+  "{d              | 3.0  | Target距离(m)       }"
+  "{w              | 5.0  | Target角速度(rad/s) }"
+  "{n              | 2000 | 规划次数             }"
+  "{@config-path   |      | yaml配置文件路径     }";
+
+using auto_aim::DT;
+using auto_aim::HALF_HORIZON;
+using auto_aim::HORIZON;
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  auto config_path = cli.get<std::string>("@config-path");
+  auto d = cli.get<double>("d");
+  auto w = cli.get<double>("w");
+  auto n = cli.get<int>("n");
+  if (cli.has("help") || !cli.has("@config-path")) {
+    cli.printMessage();
+    return 0;
+  }
+
+  auto yaml = tools::load(config_path);
+  auto max_yaw_acc = tools::read<double>(yaml, "max_yaw_acc");
+  auto Q_yaw = tools::read<std::vector<double>>(yaml, "Q_yaw");
+  auto R_yaw = tools::read<std::vector<double>>(yaml, "R_yaw");
+
+  Eigen::Matrix2d A{{1, DT}, {0, 1}};
+  Eigen::Vector2d B{0, DT};
+  Eigen::Vector2d f{0, 0};
+  Eigen::Vector2d Q(Q_yaw.data());
+  Eigen::Matrix<double, 1, 1> R(R_yaw.data());
+
+  // 1. 现有的动态维度求解器，配置与Planner::setup_yaw_solver一致
+  TinySolver * dynamic_solver;
+  Eigen::MatrixXd A_dyn = A, B_dyn = B, f_dyn = f;
+  tiny_setup(
+    &dynamic_solver, A_dyn, B_dyn, f_dyn, Q.asDiagonal(), R.asDiagonal(), 1.0, 2, 1, HORIZON, 0);
+  Eigen::MatrixXd x_min = Eigen::MatrixXd::Constant(2, HORIZON, -1e17);
+  Eigen::MatrixXd x_max = Eigen::MatrixXd::Constant(2, HORIZON, 1e17);
+  Eigen::MatrixXd u_min = Eigen::MatrixXd::Constant(1, HORIZON - 1, -max_yaw_acc);
+  Eigen::MatrixXd u_max = Eigen::MatrixXd::Constant(1, HORIZON - 1, max_yaw_acc);
+  tiny_set_bound_constraints(dynamic_solver, x_min, x_max, u_min, u_max);
+  dynamic_solver->settings->max_iter = 10;
+
+  // 2. 定长求解器，状态约束为±1e17等同于不启用
+  tinympc::TinySolver<2, 1, HORIZON> fixed_solver;
+  fixed_solver.setup(A, B, f, Q, R, 1.0);
+  fixed_solver.set_input_bound(u_min, u_max);
+  fixed_solver.settings.max_iter = 10;
+
+  // 3. 代码生成的定长求解器，缓存应与现场计算的一致
+  auto data = auto_aim::find_static_solver(
+    auto_aim::solver_hash(DT, HORIZON, max_yaw_acc, Q_yaw, R_yaw, 1.0));
+  if (data == nullptr) {
+    tools::logger()->warn("No generated solver for {}, run planner_codegen first", config_path);
+  } else {
+    auto_aim::StaticSolver static_solver;
+    auto_aim::setup_static_solver(static_solver, *data, DT);
+    auto cache_diff = std::max(
+      (static_solver.cache.Kinf - fixed_solver.cache.Kinf).cwiseAbs().maxCoeff(),
+      (static_solver.cache.Pinf - fixed_solver.cache.Pinf).cwiseAbs().maxCoeff() /
+        fixed_solver.cache.Pinf.cwiseAbs().maxCoeff());
+    tools::logger()->info("generated cache difference: {:.3e}", cache_diff);
+    if (cache_diff > 1e-9) return 1;
+  }
+
+  auto_aim::Target target(d, w, 0.2, 0.1);
+  double dynamic_us = 0, fixed_us = 0, max_diff = 0;
+  int dynamic_iter = 0, fixed_iter = 0;
+
+  for (int k = 0; k < n; k++) {
+    target.predict(0.01);
+    auto traj = reference(target.snapshot(), 22);
+    Eigen::Vector2d x0{traj(0, 0), traj(1, 0)};
+
+    auto start = std::chrono::steady_clock::now();
+    tiny_set_x0(dynamic_solver, x0);
+    dynamic_solver->work->Xref = traj.block(0, 0, 2, HORIZON);
+    tiny_solve(dynamic_solver);
+    auto mid = std::chrono::steady_clock::now();
+    fixed_solver.set_x0(x0);
+    fixed_solver.work.Xref = traj.block<2, HORIZON>(0, 0);
+    fixed_solver.solve();
+    auto end = std::chrono::steady_clock::now();
+
+    dynamic_us += tools::delta_time(mid, start) * 1e6;
+    fixed_us += tools::delta_time(end, mid) * 1e6;
+    dynamic_iter += dynamic_solver->work->iter;
+    fixed_iter += fixed_solver.work.iter;
+    max_diff = std::max(
+      max_diff, (dynamic_solver->work->x - fixed_solver.work.x).cwiseAbs().maxCoeff());
+  }
+
+  tools::logger()->info(
+    "d={:.1f}m w={:.1f}rad/s tiny_solve: {:.2f}us ({:.1f} iter), TinySolver<2, 1, {}>: {:.2f}us "
+    "({:.1f} iter)",
+    d, w, dynamic_us / n, double(dynamic_iter) / n, HORIZON, fixed_us / n, double(fixed_iter) / n);
+  tools::logger()->info("max state difference: {:.3e}", max_diff);
+
+  return max_diff < 1e-6 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <vector>
+
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/tracer.hpp"
+
+const std::string keys =
+  "{help h usage ? |            | 输出命令行参数说明             }"
+  "{threads        | 3          | 追踪线程数                     }"
+  "{n              | 20000      | 每个线程的帧数，超过缓冲区时只保留最新的 }"
+  "{output o       | trace.json | Chrome trace文件               }";
+
+int fake_work(int n)
+{
+  volatile int sum = 0;
+  for (int i = 0; i < n; i++) sum = sum + i;
+  return sum;
+}
+
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto threads = cli.get<int>("threads");
+  auto n = cli.get<int>("n");
+  auto output = cli.get<std::string>("output");
+
+  // 1. 每帧两个嵌套的区间，记录时另一个线程随时导出
+  std::vector<double> span_ns(threads);
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; i++)
+    workers.emplace_back([&, i] {
+      TOOLS_TRACE_THREAD(fmt::format("worker{}", i));
+      auto start = std::chrono::steady_clock::now();
+      for (int frame = 0; frame < n; frame++) {
+        TOOLS_TRACE_FRAME(frame);
+        TOOLS_TRACE_SPAN("frame");
+        TOOLS_TRACE_CALL("work", fake_work(10));
+      }
+      span_ns[i] = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e9 / n / 2;
+    });
+  tools::trace::save(output);
+  for (auto & worker : workers) worker.join();
+
+  // 2. 空区间的开销
+  constexpr int REPEAT = 1000000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < REPEAT; i++) TOOLS_TRACE_SPAN("empty");
+  auto empty_ns = tools::delta_time(std::chrono::steady_clock::now(), start) * 1e9 / REPEAT;
+
+  // 3. 线程退出后仍能导出，每个线程的事件按帧号成对出现
+  tools::trace::clear();  // 丢弃已退出线程和"empty"
+  for (int i = 0; i < threads; i++)
+    workers[i] = std::thread([&, i] {
+      TOOLS_TRACE_THREAD(fmt::format("worker{}", i));
+      for (int frame = 0; frame < n; frame++) {
+        TOOLS_TRACE_FRAME(frame);
+        TOOLS_TRACE_SPAN("frame");
+        TOOLS_TRACE_CALL("work", fake_work(10));
+      }
+    });
+  for (auto & worker : workers) worker.join();
+  if (!tools::trace::save(output)) return 1;
+
+  std::ifstream file(output);
+  auto trace = nlohmann::json::parse(file);
+  std::map<int, int> events;  // tid -> 事件数
+  int names = 0, unpaired = 0;
+  std::map<std::pair<int, uint64_t>, int> frames;
+  for (const auto & event : trace["traceEvents"]) {
+    if (event["ph"] == "M") {
+      names++;
+      continue;
+    }
+    auto tid = event["tid"].get<int>();
+    events[tid]++;
+    frames[{tid, event["args"]["frame"].get<uint64_t>()}]++;
+  }
+  for (const auto & [key, count] : frames) unpaired += count != 2;
+
+  tools::logger()->info(
+    "span {:.1f}ns under load, empty span {:.1f}ns",
+    std::accumulate(span_ns.begin(), span_ns.end(), 0.0) / threads, empty_ns);
+  tools::logger()->info(
+    "{} threads, {} named, {} frames, {} unpaired", events.size(), names, frames.size(), unpaired);
+
+  // 缓冲区满时最早的一帧可能只剩内层区间
+  return events.size() == std::size_t(threads) && names == threads && unpaired <= threads ? 0 : 1;
+}
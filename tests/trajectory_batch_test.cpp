@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include <random>
+
+#include "tools/ballistic_table.hpp"
+#include "tools/logger.hpp"
+#include "tools/math_tools.hpp"
+#include "tools/simd_math.hpp"
+#include "tools/trajectory.hpp"
+
+const std::string keys =
+  "{help h usage ? |       | 输出命令行参数说明                 }"
+  "{k              | 0     | 阻力系数(1/m)，0表示不考虑空气阻力 }"
+  "{repeat r       | 20000 | 生成参考轨迹的重复次数             }";
+
+constexpr int N = 102;  // 与规划时域相同：HORIZON + 2
+constexpr double DT = 0.01;
+
+// 以4块装甲板、半径0.25m、角速度8rad/s的整车为例，生成时域内最近装甲板的坐标
+void horizon_xyz(double x0, double y0, double z0, double * x, double * y, double * z)
+{
+  for (int i = 0; i < N; i++) {
+    auto min_dist2 = 1e10;
+    for (int id = 0; id < 4; id++) {
+      auto a = 8 * DT * i + id * M_PI / 2;
+      auto ax = x0 - 0.25 * std::cos(a), ay = y0 - 0.25 * std::sin(a);
+      if (ax * ax + ay * ay < min_dist2) {
+        min_dist2 = ax * ax + ay * ay;
+        x[i] = ax;
+        y[i] = ay;
+        z[i] = z0;
+      }
+    }
+  }
+}
+
+// 比较逐点求解与批量求解一条参考轨迹(yaw, pitch)的结果和耗时
+int main(int argc, char * argv[])
+{
+  cv::CommandLineParser cli(argc, argv, keys);
+  if (cli.has("help")) {
+    cli.printMessage();
+    return 0;
+  }
+  auto k = cli.get<double>("k");
+  auto repeat = cli.get<int>("repeat");
+
+  std::shared_ptr<const tools::BallisticTable> table;
+  if (k > 0) {
+    tools::BallisticTableParams params;
+    params.k = k;
+    table = std::make_shared<const tools::BallisticTable>(params);
+  }
+
+  // 1. simd_atan2在四个象限及坐标轴上的精度
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-10, 10);
+  auto max_atan2_error = 0.0;
+  auto check_atan2 = [&](double y, double x) {
+    auto error = std::abs(tools::simd_atan2(y, x) - std::atan2(y, x));
+    max_atan2_error = std::max(max_atan2_error, error);
+  };
+  for (int i = 0; i < 1000000; i++) check_atan2(dist(rng), dist(rng));
+  for (auto y : {-1.0, -0.0, 0.0, 1.0})
+    for (auto x : {-1.0, -0.0, 0.0, 1.0}) check_atan2(y, x);
+
+  // 2. 参考轨迹
+  std::array<double, N> x, y, z, d, yaw, elevation, distance, pitch, fly_time;
+  horizon_xyz(4.0, 1.5, 0.3, x.data(), y.data(), z.data());
+  auto bullet_speed = 22.0;
+
+  auto scalar = [&](double * yaw_out, double * pitch_out) {
+    for (int i = 0; i < N; i++) {
+      auto traj = tools::solve_trajectory(table, bullet_speed, std::hypot(x[i], y[i]), z[i]);
+      yaw_out[i] = std::atan2(y[i], x[i]);
+      pitch_out[i] = traj.unsolvable ? std::nan("") : traj.pitch;
+    }
+  };
+  auto batch = [&]() {
+    for (int i = 0; i < N; i++) d[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+    tools::xyz2ypd(x.data(), y.data(), z.data(), yaw.data(), elevation.data(), distance.data(), N);
+    tools::solve_trajectory(
+      table, bullet_speed, d.data(), z.data(), pitch.data(), fly_time.data(), N);
+  };
+
+  std::array<double, N> yaw_ref, pitch_ref;
+  scalar(yaw_ref.data(), pitch_ref.data());
+  batch();
+  auto max_yaw_error = 0.0, max_pitch_error = 0.0;
+  for (int i = 0; i < N; i++) {
+    max_yaw_error = std::max(max_yaw_error, std::abs(yaw[i] - yaw_ref[i]));
+    max_pitch_error = std::max(max_pitch_error, std::abs(pitch[i] - pitch_ref[i]));
+  }
+
+  // 3. 每次生成参考轨迹的耗时
+  auto sink = 0.0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; r++) {
+    scalar(yaw_ref.data(), pitch_ref.data());
+    sink += yaw_ref[r % N];
+  }
+  auto scalar_us = tools::delta_time(std::chrono::steady_clock::now(), t0) * 1e6 / repeat;
+
+  t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; r++) {
+    batch();
+    sink += yaw[r % N];
+  }
+  auto batch_us = tools::delta_time(std::chrono::steady_clock::now(), t0) * 1e6 / repeat;
+
+  tools::logger()->info("simd_atan2 error max {:.2e}rad", max_atan2_error);
+  tools::logger()->info(
+    "horizon({}) yaw error max {:.2e}rad, pitch error max {:.2e}rad", N, max_yaw_error,
+    max_pitch_error);
+  tools::logger()->info(
+    "per horizon build: scalar {:.2f}us, batch {:.2f}us, {:.1f}x ({:.0f})", scalar_us, batch_us,
+    scalar_us / batch_us, sink);
+
+  return (max_atan2_error < 1e-12 && max_yaw_error < 1e-12 && max_pitch_error < 1e-12) ? 0 : 1;
+}
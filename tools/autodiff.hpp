@@ -0,0 +1,151 @@
+#ifndef TOOLS__AUTODIFF_HPP
+#define TOOLS__AUTODIFF_HPP
+
+#include <Eigen/Dense>
+#include <array>
+#include <cmath>
+
+#include "math_tools.hpp"
+
+namespace tools
+{
+// 前向模式自动微分的对偶数
+// v为函数值，d为对N个自变量的偏导数
+template <int N>
+struct Dual
+{
+  double v;
+  Eigen::Matrix<double, N, 1> d;
+
+  Dual() : v(0), d(Eigen::Matrix<double, N, 1>::Zero()) {}
+  Dual(double v) : v(v), d(Eigen::Matrix<double, N, 1>::Zero()) {}
+  Dual(double v, const Eigen::Matrix<double, N, 1> & d) : v(v), d(d) {}
+
+  // 第i个自变量
+  static Dual variable(double v, int i)
+  {
+    Dual x(v);
+    x.d[i] = 1;
+    return x;
+  }
+
+  Dual & operator+=(const Dual & b) { return *this = *this + b; }
+  Dual & operator-=(const Dual & b) { return *this = *this - b; }
+  Dual & operator*=(const Dual & b) { return *this = *this * b; }
+  Dual & operator/=(const Dual & b) { return *this = *this / b; }
+};
+
+// clang-format off
+template <int N> Dual<N> operator+(const Dual<N> & a, const Dual<N> & b) { return {a.v + b.v, a.d + b.d}; }
+template <int N> Dual<N> operator-(const Dual<N> & a, const Dual<N> & b) { return {a.v - b.v, a.d - b.d}; }
+template <int N> Dual<N> operator*(const Dual<N> & a, const Dual<N> & b) { return {a.v * b.v, b.v * a.d + a.v * b.d}; }
+template <int N> Dual<N> operator/(const Dual<N> & a, const Dual<N> & b) { return {a.v / b.v, (b.v * a.d - a.v * b.d) / (b.v * b.v)}; }
+template <int N> Dual<N> operator-(const Dual<N> & a) { return {-a.v, -a.d}; }
+
+template <int N> Dual<N> operator+(const Dual<N> & a, double b) { return {a.v + b, a.d}; }
+template <int N> Dual<N> operator+(double a, const Dual<N> & b) { return {a + b.v, b.d}; }
+template <int N> Dual<N> operator-(const Dual<N> & a, double b) { return {a.v - b, a.d}; }
+template <int N> Dual<N> operator-(double a, const Dual<N> & b) { return {a - b.v, -b.d}; }
+template <int N> Dual<N> operator*(const Dual<N> & a, double b) { return {a.v * b, a.d * b}; }
+template <int N> Dual<N> operator*(double a, const Dual<N> & b) { return {a * b.v, a * b.d}; }
+template <int N> Dual<N> operator/(const Dual<N> & a, double b) { return {a.v / b, a.d / b}; }
+template <int N> Dual<N> operator/(double a, const Dual<N> & b) { return {a / b.v, -a * b.d / (b.v * b.v)}; }
+// clang-format on
+
+template <int N>
+Dual<N> sin(const Dual<N> & a)
+{
+  return {std::sin(a.v), std::cos(a.v) * a.d};
+}
+
+template <int N>
+Dual<N> cos(const Dual<N> & a)
+{
+  return {std::cos(a.v), -std::sin(a.v) * a.d};
+}
+
+template <int N>
+Dual<N> sqrt(const Dual<N> & a)
+{
+  auto s = std::sqrt(a.v);
+  return {s, a.d / (2 * s)};
+}
+
+template <int N>
+Dual<N> atan2(const Dual<N> & y, const Dual<N> & x)
+{
+  auto r2 = x.v * x.v + y.v * y.v;
+  return {std::atan2(y.v, x.v), (x.v * y.d - y.v * x.d) / r2};
+}
+
+// 与double版本的limit_rad一致，只平移函数值，导数不变
+template <int N>
+Dual<N> limit_rad(const Dual<N> & a)
+{
+  return {limit_rad(a.v), a.d};
+}
+
+// 函数值
+inline double value(double a) { return a; }
+
+template <int N>
+double value(const Dual<N> & a)
+{
+  return a.v;
+}
+
+// 对f: R^N -> R^M在x处求雅可比矩阵
+// f须为泛型可调用对象，接受std::array<T, N>并返回std::array<T, M>，T为double或Dual<N>
+template <int M, int N, typename F>
+Eigen::Matrix<double, M, N> jacobian(
+  F && f, const Eigen::Matrix<double, N, 1> & x, Eigen::Matrix<double, M, 1> * fx = nullptr)
+{
+  std::array<Dual<N>, N> x_dual;
+  for (int i = 0; i < N; i++) x_dual[i] = Dual<N>::variable(x[i], i);
+
+  std::array<Dual<N>, M> y_dual = f(x_dual);
+
+  Eigen::Matrix<double, M, N> J;
+  for (int i = 0; i < M; i++) {
+    J.row(i) = y_dual[i].d.transpose();
+    if (fx) (*fx)[i] = y_dual[i].v;
+  }
+  return J;
+}
+
+// 泛型版本的坐标变换，可同时用于求值和自动微分
+// 与math_tools中的xyz2ypd/ypd2xyz一致
+template <typename T>
+std::array<T, 3> xyz2ypd(const std::array<T, 3> & xyz)
+{
+  using std::atan2, std::sqrt;
+  const auto & x = xyz[0];
+  const auto & y = xyz[1];
+  const auto & z = xyz[2];
+  return {atan2(y, x), atan2(z, sqrt(x * x + y * y)), sqrt(x * x + y * y + z * z)};
+}
+
+template <typename T>
+std::array<T, 3> ypd2xyz(const std::array<T, 3> & ypd)
+{
+  using std::cos, std::sin;
+  const auto & yaw = ypd[0];
+  const auto & pitch = ypd[1];
+  const auto & distance = ypd[2];
+  return {
+    distance * cos(pitch) * cos(yaw), distance * cos(pitch) * sin(yaw), distance * sin(pitch)};
+}
+
+inline Eigen::Matrix3d xyz2ypd_jacobian_ad(const Eigen::Vector3d & xyz)
+{
+  return jacobian<3, 3>([](const auto & x) { return xyz2ypd(x); }, xyz);
+}
+
+inline Eigen::Matrix3d ypd2xyz_jacobian_ad(const Eigen::Vector3d & ypd)
+{
+  return jacobian<3, 3>([](const auto & x) { return ypd2xyz(x); }, ypd);
+}
+
+}  // namespace tools
+
+#endif  // TOOLS__AUTODIFF_HPP
@@ -0,0 +1,289 @@
+#include "ballistic_table.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "logger.hpp"
+#include "math_tools.hpp"
+#include "yaml.hpp"
+
+namespace tools
+{
+namespace
+{
+constexpr char MAGIC[4] = {'B', 'L', 'T', 'B'};
+constexpr uint32_t VERSION = 1;  // 修改积分方法或表格布局时递增，使旧缓存失效
+
+// 生成表格时扫描的出射角
+constexpr double MIN_PITCH = -80 / 57.3;
+constexpr double MAX_PITCH = 60 / 57.3;
+constexpr double PITCH_STEP = 0.25 / 57.3;
+
+struct FileHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint64_t hash;
+  int32_t v0_num, d_num, h_num;
+};
+
+// FNV-1a
+uint64_t params_hash(const BallisticTableParams & p)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto mix = [&](double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; i++) {
+      hash ^= (bits >> (8 * i)) & 0xff;
+      hash *= 0x100000001b3ULL;
+    }
+  };
+  for (auto value : {double(VERSION), p.k, p.v0_min, p.v0_max, p.v0_step, p.d_min, p.d_max,
+                     p.d_step, p.h_min, p.h_max, p.h_step})
+    mix(value);
+  return hash;
+}
+
+int grid_num(double min, double max, double step) { return std::lround((max - min) / step) + 1; }
+
+double lerp(double a, double b, double w) { return a + w * (b - a); }
+
+// 读取[min, max, step]形式的网格范围
+void read_range(
+  const YAML::Node & yaml, const std::string & key, double & min, double & max, double & step)
+{
+  auto range = tools::read<std::vector<double>>(yaml, key);
+  if (range.size() != 3 || !(range[0] < range[1]) || !(range[2] > 0))
+    throw std::invalid_argument("BallisticTable: " + key + " should be [min, max, step]");
+  min = range[0];
+  max = range[1];
+  step = range[2];
+}
+
+}  // namespace
+
+BallisticTable::BallisticTable(const BallisticTableParams & params) : BallisticTable(params, true)
+{
+}
+
+BallisticTable::BallisticTable(const BallisticTableParams & params, bool build)
+: params_(params),
+  hash_(params_hash(params)),
+  v0_num_(grid_num(params.v0_min, params.v0_max, params.v0_step)),
+  d_num_(grid_num(params.d_min, params.d_max, params.d_step)),
+  h_num_(grid_num(params.h_min, params.h_max, params.h_step)),
+  dpitch_(v0_num_ * d_num_ * h_num_),
+  dfly_time_(v0_num_ * d_num_ * h_num_)
+{
+  if (!build) return;
+
+  // 各初速之间相互独立，按初速分给多个线程
+  auto thread_num = std::max(1, std::min<int>(std::thread::hardware_concurrency(), v0_num_));
+  std::vector<std::thread> threads;
+  for (int k = 0; k < thread_num; k++)
+    threads.emplace_back([this, k, thread_num] {
+      for (int iv = k; iv < v0_num_; iv += thread_num) build_v0(iv);
+    });
+  for (auto & thread : threads) thread.join();
+}
+
+// 对每个出射角积分一次，得到各距离上的命中高度；再在每个距离上沿低伸弹道（高度随出射角递增的一段）
+// 把高度反插值为出射角，减去无阻力解析解后存为修正量
+void BallisticTable::build_v0(int iv)
+{
+  const auto & p = params_;
+  auto v0 = p.v0_min + iv * p.v0_step;
+  auto pitch_num = grid_num(MIN_PITCH, MAX_PITCH, PITCH_STEP);
+
+  std::vector<double> d_list(d_num_);
+  for (int id = 0; id < d_num_; id++) d_list[id] = p.d_min + id * p.d_step;
+
+  // 按(出射角, 距离)存放
+  std::vector<double> y(pitch_num * d_num_), t(pitch_num * d_num_);
+  for (int k = 0; k < pitch_num; k++)
+    sample_trajectory(
+      p.k, v0, MIN_PITCH + k * PITCH_STEP, d_list.data(), d_num_, &y[k * d_num_],
+      &t[k * d_num_]);
+
+  for (int id = 0; id < d_num_; id++) {
+    auto at = [&](int k) { return k * d_num_ + id; };
+
+    // 出射角过低时弹丸在到达该距离前已落到MIN_HEIGHT以下
+    int k = 0;
+    while (k + 1 < pitch_num && std::isnan(y[at(k)])) k++;
+
+    for (int ih = 0; ih < h_num_; ih++) {
+      auto h = p.h_min + ih * p.h_step;
+      while (k + 1 < pitch_num && y[at(k + 1)] > y[at(k)] && y[at(k + 1)] < h) k++;
+
+      auto & pitch = dpitch_[index(iv, id, ih)];
+      auto & fly_time = dfly_time_[index(iv, id, ih)];
+      auto y0 = y[at(k)], y1 = k + 1 < pitch_num ? y[at(k + 1)] : y0;
+      if (!(y0 <= h && h <= y1 && y1 > y0)) {
+        pitch = fly_time = std::numeric_limits<double>::quiet_NaN();
+        continue;
+      }
+
+      // 空气阻力使射程变短，有阻力时可达的点无阻力时一定可达
+      auto w = (h - y0) / (y1 - y0);
+      Trajectory drag_free(v0, d_list[id], h);
+      pitch = MIN_PITCH + (k + w) * PITCH_STEP - drag_free.pitch;
+      fly_time = lerp(t[at(k)], t[at(k + 1)], w) - drag_free.fly_time;
+    }
+  }
+}
+
+std::shared_ptr<const BallisticTable> BallisticTable::from_config(const std::string & config_path)
+{
+  auto yaml = tools::load(config_path);
+  if (!yaml["bullet_drag"] || yaml["bullet_drag"].as<double>() <= 0) return nullptr;
+
+  BallisticTableParams p;
+  p.k = tools::read<double>(yaml, "bullet_drag");
+  read_range(yaml, "ballistic_v0", p.v0_min, p.v0_max, p.v0_step);
+  read_range(yaml, "ballistic_d", p.d_min, p.d_max, p.d_step);
+  read_range(yaml, "ballistic_h", p.h_min, p.h_max, p.h_step);
+  auto cache_dir = tools::read<std::string>(yaml, "ballistic_cache");
+  auto path = fmt::format("{}/ballistic_{:016x}.bin", cache_dir, params_hash(p));
+
+  // Planner和CommandStreamer等各自调用，只有第一次读取或生成，加锁也避免同时生成
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::weak_ptr<const BallisticTable>> tables;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (auto shared = tables[path].lock()) return shared;
+
+  auto table = load(path, p);
+  if (table) {
+    tools::logger()->info("[BallisticTable] Loaded {}", path);
+    tables[path] = table;
+    return table;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto built = std::make_shared<const BallisticTable>(p);
+  tools::logger()->info(
+    "[BallisticTable] Built k={} in {:.2f}s", p.k,
+    tools::delta_time(std::chrono::steady_clock::now(), start));
+
+  std::error_code ec;
+  std::filesystem::create_directories(cache_dir, ec);
+  if (!built->save(path)) tools::logger()->warn("[BallisticTable] Failed to save {}", path);
+  tables[path] = built;
+  return built;
+}
+
+std::shared_ptr<const BallisticTable> BallisticTable::load(
+  const std::string & path, const BallisticTableParams & params)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return nullptr;
+
+  std::shared_ptr<BallisticTable> table(new BallisticTable(params, false));
+  FileHeader header{};
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (
+    !file || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+    header.hash != table->hash_ || header.v0_num != table->v0_num_ ||
+    header.d_num != table->d_num_ || header.h_num != table->h_num_)
+    return nullptr;
+
+  auto bytes = table->dpitch_.size() * sizeof(double);
+  file.read(reinterpret_cast<char *>(table->dpitch_.data()), bytes);
+  file.read(reinterpret_cast<char *>(table->dfly_time_.data()), bytes);
+  if (!file) return nullptr;
+
+  return table;
+}
+
+bool BallisticTable::save(const std::string & path) const
+{
+  std::ofstream file(path, std::ios::binary);
+  if (!file) return false;
+
+  FileHeader header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.hash = hash_;
+  header.v0_num = v0_num_;
+  header.d_num = d_num_;
+  header.h_num = h_num_;
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  auto bytes = dpitch_.size() * sizeof(double);
+  file.write(reinterpret_cast<const char *>(dpitch_.data()), bytes);
+  file.write(reinterpret_cast<const char *>(dfly_time_.data()), bytes);
+  return bool(file);
+}
+
+Trajectory BallisticTable::query(double v0, double d, double h) const
+{
+  Trajectory result;
+  query(v0, &d, &h, &result.pitch, &result.fly_time, 1);
+  result.unsolvable = std::isnan(result.pitch);
+  return result;
+}
+
+void BallisticTable::query(
+  double v0, const double * d, const double * h, double * pitch, double * fly_time, int n) const
+{
+  const auto & p = params_;
+
+  // 先批量求无阻力解析解，不可解时为NaN并传播到结果中
+  Trajectory::solve_batch(v0, d, h, pitch, fly_time, n);
+
+  // 网格外不外推修正量，视为unsolvable；NaN输入同样落在网格外
+  auto outside = [](double f, int num) { return !(f >= 0 && f <= num - 1); };
+  auto fv = (v0 - p.v0_min) / p.v0_step;
+  if (outside(fv, v0_num_)) {
+    std::fill(pitch, pitch + n, std::numeric_limits<double>::quiet_NaN());
+    std::fill(fly_time, fly_time + n, std::numeric_limits<double>::quiet_NaN());
+    return;
+  }
+  auto iv = std::min(int(fv), v0_num_ - 2);
+  auto wv = fv - iv;
+
+  const auto * pitch0 = &dpitch_[index(iv, 0, 0)];
+  const auto * pitch1 = &dpitch_[index(iv + 1, 0, 0)];
+  const auto * time0 = &dfly_time_[index(iv, 0, 0)];
+  const auto * time1 = &dfly_time_[index(iv + 1, 0, 0)];
+
+  for (int i = 0; i < n; i++) {
+    auto fd = (d[i] - p.d_min) / p.d_step;
+    auto fh = (h[i] - p.h_min) / p.h_step;
+    if (outside(fd, d_num_) || outside(fh, h_num_)) {
+      pitch[i] = fly_time[i] = std::numeric_limits<double>::quiet_NaN();
+      continue;
+    }
+    auto id = std::min(int(fd), d_num_ - 2);
+    auto ih = std::min(int(fh), h_num_ - 2);
+    auto wd = fd - id;
+    auto wh = fh - ih;
+    auto c00 = id * h_num_ + ih;
+    auto c01 = c00 + 1;
+    auto c10 = c00 + h_num_;
+    auto c11 = c10 + 1;
+
+    // 不可达的顶点以NaN参与插值，结果为unsolvable
+    auto trilinear = [&](const double * layer0, const double * layer1) {
+      auto a = lerp(lerp(layer0[c00], layer0[c01], wh), lerp(layer0[c10], layer0[c11], wh), wd);
+      auto b = lerp(lerp(layer1[c00], layer1[c01], wh), lerp(layer1[c10], layer1[c11], wh), wd);
+      return lerp(a, b, wv);
+    };
+    pitch[i] += trilinear(pitch0, pitch1);
+    fly_time[i] += trilinear(time0, time1);
+  }
+}
+
+}  // namespace tools
@@ -0,0 +1,82 @@
+#ifndef TOOLS__BALLISTIC_TABLE_HPP
+#define TOOLS__BALLISTIC_TABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trajectory.hpp"
+
+namespace tools
+{
+// 网格范围由配置文件的ballistic_v0/ballistic_d/ballistic_h给出，默认值供测试使用
+struct BallisticTableParams
+{
+  double k;  // 阻力系数，单位：1/m
+  double v0_min = 10.0, v0_max = 30.0, v0_step = 0.5;
+  double d_min = 0.5, d_max = 15.0, d_step = 0.25;
+  double h_min = -2.0, h_max = 3.0, h_step = 0.05;
+};
+
+// 考虑空气阻力的弹道查找表
+// 在(v0, d, h)网格上预先求出低伸弹道的出射角和飞行时间相对无阻力解析解的修正量，查询时在解析解上
+// 加三线性插值的修正量。近距离时出射角随h/d剧烈变化，但修正量平滑，网格可以较粗
+// 网格外或插值单元中有不可达顶点时视为unsolvable
+class BallisticTable
+{
+public:
+  explicit BallisticTable(const BallisticTableParams & params);
+
+  // 读取bullet_drag和网格范围，bullet_drag未配置或为0时返回nullptr
+  // 表格按参数哈希缓存到ballistic_cache目录下，参数不变时直接读取
+  // 同一进程内参数相同的调用共享同一张表
+  static std::shared_ptr<const BallisticTable> from_config(const std::string & config_path);
+
+  static std::shared_ptr<const BallisticTable> load(
+    const std::string & path, const BallisticTableParams & params);
+  bool save(const std::string & path) const;
+
+  Trajectory query(double v0, double d, double h) const;
+
+  // 同一初速下批量查询，unsolvable时pitch和fly_time为NaN
+  void query(
+    double v0, const double * d, const double * h, double * pitch, double * fly_time,
+    int n) const;
+
+  const BallisticTableParams & params() const { return params_; }
+  uint64_t hash() const { return hash_; }
+
+private:
+  BallisticTableParams params_;
+  uint64_t hash_;
+  int v0_num_, d_num_, h_num_;
+  std::vector<double> dpitch_;  // 按(v0, d, h)行优先存放
+  std::vector<double> dfly_time_;
+
+  BallisticTable(const BallisticTableParams & params, bool build);
+  void build_v0(int iv);
+  int index(int iv, int id, int ih) const { return (iv * d_num_ + id) * h_num_ + ih; }
+};
+
+// table为空（未配置空气阻力）时退回到不考虑空气阻力的解析解
+inline Trajectory solve_trajectory(
+  const std::shared_ptr<const BallisticTable> & table, double v0, double d, double h)
+{
+  return table ? table->query(v0, d, h) : Trajectory(v0, d, h);
+}
+
+// 批量版本，unsolvable时pitch和fly_time为NaN
+inline void solve_trajectory(
+  const std::shared_ptr<const BallisticTable> & table, double v0, const double * d,
+  const double * h, double * pitch, double * fly_time, int n)
+{
+  if (table)
+    table->query(v0, d, h, pitch, fly_time, n);
+  else
+    Trajectory::solve_batch(v0, d, h, pitch, fly_time, n);
+}
+
+}  // namespace tools
+
+#endif  // TOOLS__BALLISTIC_TABLE_HPP
@@ -0,0 +1,697 @@
+#include "frame_log.hpp"
+
+#include <fcntl.h>
+#include <jpeglib.h>
+#include <lz4.h>
+#include <pthread.h>  // pthread_setschedparam
+#include <sched.h>    // SCHED_IDLE
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csetjmp>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "logger.hpp"
+#include "math_tools.hpp"
+
+namespace tools
+{
+namespace
+{
+using namespace frame_log;
+
+constexpr std::size_t BLOCK = 4096;                 // O_DIRECT要求的对齐
+constexpr std::size_t CHUNK = 8 * 1024 * 1024;      // 每次写入的大小
+constexpr RecordType PADDING = RecordType(0);       // 环形缓冲区末尾的填充，不写入文件
+constexpr RecordType DROPPED = RecordType(0xffff);  // DROP_OLDEST丢弃的记录，不写入文件
+
+constexpr char INDEX_MAGIC[4] = {'F', 'I', 'D', 'X'};
+constexpr const char * INDEX_NAME = "index.fidx";
+
+int64_t thread_cpu_ns()
+{
+  timespec ts;
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// libjpeg默认的error_exit会调用exit()，改为跳回出错的压缩调用
+struct JpegError
+{
+  jpeg_error_mgr mgr;
+  std::jmp_buf jump;
+};
+
+void jpeg_error_exit(j_common_ptr cinfo)
+{
+  char message[JMSG_LENGTH_MAX];
+  cinfo->err->format_message(cinfo, message);
+  TOOLS_LOG_WARN_LIMITED(1, "[FrameLogWriter] JPEG: {}", message);
+  std::longjmp(reinterpret_cast<JpegError *>(cinfo->err)->jump, 1);
+}
+
+// 压缩失败返回false；缓冲不够时libjpeg另行分配并更新buffer和size，原缓冲由调用方释放
+// setjmp之后不构造有析构函数的对象，longjmp不会跳过析构
+bool compress_jpeg(
+  const FrameInfo & info, const char * raw, int quality, unsigned char *& buffer,
+  unsigned long & size)
+{
+  jpeg_compress_struct cinfo{};
+  JpegError error;
+  cinfo.err = jpeg_std_error(&error.mgr);
+  error.mgr.error_exit = jpeg_error_exit;
+  if (setjmp(error.jump)) {
+    jpeg_destroy_compress(&cinfo);
+    return false;
+  }
+
+  jpeg_create_compress(&cinfo);
+  jpeg_mem_dest(&cinfo, &buffer, &size);
+  cinfo.image_width = info.cols;
+  cinfo.image_height = info.rows;
+  cinfo.input_components = info.type == CV_8UC1 ? 1 : 3;
+  cinfo.in_color_space = info.type == CV_8UC1 ? JCS_GRAYSCALE : JCS_EXT_BGR;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
+  cinfo.dct_method = JDCT_IFAST;
+  jpeg_start_compress(&cinfo, TRUE);
+  auto stride = info.cols * cinfo.input_components;
+  while (cinfo.next_scanline < cinfo.image_height) {
+    auto * row = const_cast<JSAMPLE *>(
+      reinterpret_cast<const JSAMPLE *>(raw + std::size_t(cinfo.next_scanline) * stride));
+    jpeg_write_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+  return true;
+}
+
+struct IndexHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t segments;  // 之后是各段的大小，均与录像一致时索引才有效
+  uint32_t reserved;
+  uint64_t frames;
+};
+
+}  // namespace
+
+FrameLogWriter::FrameLogWriter(const std::string & dir, const FrameLogOptions & options)
+: dir_(dir),
+  options_(options),
+  ring_(new char[aligned(options.ring_size)]),
+  ring_size_(aligned(options.ring_size))
+{
+  std::filesystem::create_directories(dir_);
+
+  // 预先触碰每一页，避免运行中缺页
+  std::memset(ring_.get(), 0, ring_size_);
+  if (posix_memalign(reinterpret_cast<void **>(&staging_), BLOCK, CHUNK) != 0)
+    throw std::runtime_error("FrameLogWriter: failed to allocate staging buffer");
+
+  open_segment();
+  for (int i = 0; i < std::max(1, options_.workers); i++)
+    workers_.emplace_back(&FrameLogWriter::work_loop, this);
+}
+
+FrameLogWriter::~FrameLogWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+  work_cv_.notify_all();
+  space_cv_.notify_all();
+  for (auto & worker : workers_) worker.join();
+
+  close_segment();
+  std::free(staging_);
+
+  auto s = stats();
+  tools::logger()->info(
+    "[FrameLogWriter] {}: {} frames, {} imus, {} sides, {} dropped, {:.1f}MB -> {:.1f}MB in {} "
+    "segments, cpu {:.2f}s",
+    dir_, s.frames, s.imus, s.sides, s.dropped, s.raw_bytes / 1e6, s.file_bytes / 1e6, s.segments,
+    s.cpu_time);
+}
+
+bool FrameLogWriter::write_frame(const cv::Mat & img, std::chrono::steady_clock::time_point t)
+{
+  if (img.empty()) return false;
+
+  // 非连续的Mat（如ROI）先拷贝成连续的
+  const cv::Mat & data = img.isContinuous() ? img : img.clone();
+  FrameInfo info{data.rows, data.cols, data.type(), 0};
+  return push(
+    RecordType::FRAME, 0, t, &info, sizeof(info), data.data, data.total() * data.elemSize());
+}
+
+bool FrameLogWriter::write_imu(
+  const Eigen::Quaterniond & q, std::chrono::steady_clock::time_point t)
+{
+  double wxyz[4] = {q.w(), q.x(), q.y(), q.z()};
+  return push(RecordType::IMU, 0, t, nullptr, 0, wxyz, sizeof(wxyz));
+}
+
+bool FrameLogWriter::write_side(
+  uint16_t channel, const void * data, std::size_t size, std::chrono::steady_clock::time_point t)
+{
+  return push(RecordType::SIDE, channel, t, nullptr, 0, data, size);
+}
+
+FrameLogWriter::Stats FrameLogWriter::stats() const
+{
+  return {frames_, imus_, sides_, dropped_, raw_bytes_, file_bytes_, segments_, cpu_ns_ * 1e-9};
+}
+
+bool FrameLogWriter::push(
+  RecordType type, uint16_t channel, std::chrono::steady_clock::time_point t, const void * prefix,
+  std::size_t prefix_size, const void * data, std::size_t size)
+{
+  auto payload = prefix_size + size;
+  auto total = sizeof(RecordHeader) + aligned(payload);
+  if (total > ring_size_ / 2) {
+    dropped_++;
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // 放不下时在末尾填充，从头开始写
+    std::size_t pos, skip;
+    while (true) {
+      pos = head_ % ring_size_;
+      skip = ring_size_ - pos < total ? ring_size_ - pos : 0;
+      auto need = skip + total;
+      if (ring_size_ - (head_ - tail_) >= need) break;
+
+      if (options_.overflow == Overflow::DROP_OLDEST)
+        while (ring_size_ - (head_ - read_) < need && read_ != head_) drop_oldest();
+
+      // 正在压缩的记录写完后空间仍不足，或不允许等待
+      auto wait = options_.overflow == Overflow::BLOCK ||
+                  (options_.overflow == Overflow::DROP_OLDEST &&
+                   ring_size_ - (head_ - read_) >= need);
+      if (!wait || quit_) {
+        dropped_++;
+        return false;
+      }
+      space_cv_.wait(lock);
+    }
+
+    if (skip >= sizeof(RecordHeader)) {
+      RecordHeader padding{};
+      padding.magic = RECORD_MAGIC;
+      padding.type = PADDING;
+      std::memcpy(ring_.get() + pos, &padding, sizeof(padding));
+    }
+    pos = (head_ + skip) % ring_size_;
+
+    RecordHeader header{};
+    header.magic = RECORD_MAGIC;
+    header.type = type;
+    header.codec = Codec::RAW;
+    header.size = payload;
+    header.raw_size = payload;
+    header.channel = channel;
+    header.seq = seq_++;
+    header.timestamp_ns = to_ns(t);
+
+    auto * dst = ring_.get() + pos;
+    std::memcpy(dst, &header, sizeof(header));
+    if (prefix_size) std::memcpy(dst + sizeof(header), prefix, prefix_size);
+    if (size) std::memcpy(dst + sizeof(header) + prefix_size, data, size);
+
+    head_ += skip + total;
+  }
+  work_cv_.notify_one();
+  return true;
+}
+
+// pos处为填充、末尾不足一个头的空隙或已丢弃的记录时返回应跳过的字节数，否则返回0
+std::size_t FrameLogWriter::skip_size(uint64_t pos) const
+{
+  auto offset = pos % ring_size_;
+  auto to_end = ring_size_ - offset;
+  if (to_end < sizeof(RecordHeader)) return to_end;
+
+  const auto * header = reinterpret_cast<const RecordHeader *>(ring_.get() + offset);
+  if (header->type == PADDING) return to_end;
+  if (header->type == DROPPED) return sizeof(RecordHeader) + aligned(header->size);
+  return 0;
+}
+
+// 调用方持有mutex_且read_ != head_
+void FrameLogWriter::drop_oldest()
+{
+  auto n = skip_size(read_);
+  if (n == 0) {
+    auto * header = reinterpret_cast<RecordHeader *>(ring_.get() + read_ % ring_size_);
+    header->type = DROPPED;
+    n = sizeof(RecordHeader) + aligned(header->size);
+    dropped_++;
+  }
+  if (tail_ == read_) tail_ += n;
+  read_ += n;
+}
+
+void FrameLogWriter::work_loop()
+{
+  // SCHED_IDLE只在没有其他可运行线程时调度，不需要权限
+  // BLOCK时写入方会等待压缩线程，压缩线程不能是最低优先级，否则CPU繁忙时写入方被无限期阻塞
+  if (options_.overflow != Overflow::BLOCK) {
+    sched_param param{};
+    auto ret = ::pthread_setschedparam(::pthread_self(), SCHED_IDLE, &param);
+    if (ret != 0)
+      tools::logger()->warn("[FrameLogWriter] Failed to set SCHED_IDLE: {}", std::strerror(ret));
+  }
+
+  // 令牌桶限流，每个线程分得cpu_quota / workers，最多积攒100ms
+  auto share = options_.cpu_quota / std::max(1, options_.workers);
+  auto max_tokens = share * 0.1;
+  auto tokens = max_tokens;
+  auto last = std::chrono::steady_clock::now();
+
+  Encoder encoder;
+  while (true) {
+    uint64_t pos;
+    RecordHeader header;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true) {
+        while (read_ != head_ && skip_size(read_) > 0) {
+          auto n = skip_size(read_);
+          if (tail_ == read_) tail_ += n;
+          read_ += n;
+        }
+        if (read_ != head_ || quit_) break;
+        work_cv_.wait(lock);
+      }
+      if (read_ == head_) break;
+
+      pos = read_;
+      std::memcpy(&header, ring_.get() + pos % ring_size_, sizeof(header));
+      read_ += sizeof(RecordHeader) + aligned(header.size);
+    }
+
+    // 压缩，不持有锁
+    auto cpu_start = thread_cpu_ns();
+    auto raw_size = header.size;
+    const auto * payload = ring_.get() + pos % ring_size_ + sizeof(RecordHeader);
+    const auto * data = encode(encoder, header, payload);
+    auto cpu_ns = thread_cpu_ns() - cpu_start;
+    cpu_ns_ += cpu_ns;
+
+    // 按领取顺序写入
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      turn_cv_.wait(lock, [&] { return tail_ == pos; });
+    }
+    write_record(header, data);
+    raw_bytes_ += raw_size;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tail_ += sizeof(RecordHeader) + aligned(raw_size);
+      while (tail_ != read_ && skip_size(tail_) > 0) tail_ += skip_size(tail_);
+    }
+    turn_cv_.notify_all();
+    space_cv_.notify_all();
+
+    if (options_.cpu_quota <= 0) continue;
+    auto now = std::chrono::steady_clock::now();
+    tokens = std::min(max_tokens, tokens + share * tools::delta_time(now, last)) - cpu_ns * 1e-9;
+    last = now;
+    if (tokens < 0) std::this_thread::sleep_for(std::chrono::duration<double>(-tokens / share));
+  }
+
+  if (encoder.jpeg) std::free(encoder.jpeg);
+}
+
+// 返回写入文件的负载，header的codec和size随之更新；压缩失败或压缩后反而更大时保持原样
+// 图像数据之前的FrameInfo不压缩
+const char * FrameLogWriter::encode(
+  Encoder & encoder, RecordHeader & header, const char * payload) const
+{
+  if (header.type != RecordType::FRAME || options_.codec == Codec::RAW) return payload;
+
+  FrameInfo info;
+  std::memcpy(&info, payload, sizeof(info));
+  const auto * raw = payload + sizeof(FrameInfo);
+  auto raw_size = header.size - sizeof(FrameInfo);
+
+  if (options_.codec == Codec::JPEG && (info.type == CV_8UC1 || info.type == CV_8UC3)) {
+    auto * buffer = encoder.jpeg;
+    auto size = encoder.jpeg_size;
+    if (!compress_jpeg(info, raw, options_.jpeg_quality, buffer, size)) {
+      if (buffer != encoder.jpeg) std::free(buffer);
+      return payload;
+    }
+    if (buffer != encoder.jpeg) {
+      std::free(encoder.jpeg);
+      encoder.jpeg = buffer;
+      encoder.jpeg_size = size;
+    }
+
+    encoder.buffer.resize(sizeof(FrameInfo) + size);
+    std::memcpy(encoder.buffer.data(), &info, sizeof(info));
+    std::memcpy(encoder.buffer.data() + sizeof(FrameInfo), buffer, size);
+    header.codec = Codec::JPEG;
+    header.size = sizeof(FrameInfo) + size;
+    return encoder.buffer.data();
+  }
+
+  auto bound = LZ4_compressBound(raw_size);
+  encoder.buffer.resize(sizeof(FrameInfo) + bound);
+  std::memcpy(encoder.buffer.data(), &info, sizeof(info));
+  auto n = LZ4_compress_default(raw, encoder.buffer.data() + sizeof(FrameInfo), raw_size, bound);
+  if (n <= 0 || std::size_t(n) >= raw_size) return payload;
+
+  header.codec = Codec::LZ4;
+  header.size = sizeof(FrameInfo) + n;
+  return encoder.buffer.data();
+}
+
+void FrameLogWriter::write_record(const RecordHeader & header, const char * payload)
+{
+  auto total = sizeof(RecordHeader) + aligned(header.size);
+  if (segment_bytes_ > sizeof(SegmentHeader) && segment_bytes_ + total > options_.segment_size) {
+    close_segment();
+    open_segment();
+  }
+
+  static const char zeros[ALIGN] = {};
+  append(&header, sizeof(header));
+  append(payload, header.size);
+  append(zeros, aligned(header.size) - header.size);
+
+  file_bytes_ += total;
+  if (header.type == RecordType::FRAME) frames_++;
+  if (header.type == RecordType::IMU) imus_++;
+  if (header.type == RecordType::SIDE) sides_++;
+}
+
+void FrameLogWriter::append(const void * data, std::size_t size)
+{
+  const auto * src = static_cast<const char *>(data);
+  segment_bytes_ += size;
+  while (size > 0) {
+    auto n = std::min(size, CHUNK - staged_);
+    std::memcpy(staging_ + staged_, src, n);
+    staged_ += n;
+    src += n;
+    size -= n;
+    if (staged_ == CHUNK) flush(false);
+  }
+}
+
+// 除最后一次外每次写入整CHUNK，文件偏移始终对齐；最后一次补零到BLOCK的整数倍，关闭前截断
+void FrameLogWriter::flush(bool final)
+{
+  if (staged_ == 0) return;
+
+  auto size = final ? (staged_ + BLOCK - 1) / BLOCK * BLOCK : staged_;
+  std::memset(staging_ + staged_, 0, size - staged_);
+
+  std::size_t written = 0;
+  while (written < size) {
+    auto n = ::write(fd_, staging_ + written, size - written);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      tools::logger()->error("[FrameLogWriter] write failed: {}", std::strerror(errno));
+      break;
+    }
+    written += n;
+  }
+  staged_ = 0;
+}
+
+void FrameLogWriter::open_segment()
+{
+  auto index = segments_.load();
+  auto path = dir_ + "/" + segment_name(index);
+
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+  direct_ = fd_ >= 0;
+  if (!direct_) {
+    // tmpfs等文件系统不支持O_DIRECT
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) throw std::runtime_error("FrameLogWriter: failed to open " + path);
+    if (index == 0) tools::logger()->warn("[FrameLogWriter] O_DIRECT unsupported in {}", dir_);
+  }
+
+  SegmentHeader header{};
+  std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+  header.version = VERSION;
+  header.index = index;
+  header.system_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  header.steady_ns = to_ns(std::chrono::steady_clock::now());
+
+  segment_bytes_ = 0;
+  append(&header, sizeof(header));
+  segments_++;
+}
+
+void FrameLogWriter::close_segment()
+{
+  if (fd_ < 0) return;
+
+  flush(true);
+  if (::ftruncate(fd_, segment_bytes_) != 0)
+    tools::logger()->warn("[FrameLogWriter] ftruncate failed: {}", std::strerror(errno));
+  ::close(fd_);
+  fd_ = -1;
+}
+
+FrameLogReader::FrameLogReader(const std::string & dir) : dir_(dir)
+{
+  for (uint32_t i = 0;; i++) {
+    auto path = dir_ + "/" + segment_name(i);
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) break;
+
+    struct stat st;
+    ::fstat(fd, &st);
+    auto size = std::size_t(st.st_size);
+    auto * data = size ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)
+                       : MAP_FAILED;
+    ::close(fd);
+    if (data == MAP_FAILED || size < sizeof(SegmentHeader)) {
+      if (data != MAP_FAILED) ::munmap(data, size);
+      tools::logger()->warn("[FrameLogReader] Skip invalid segment {}", path);
+      break;
+    }
+
+    SegmentHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (
+      std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0 ||
+      header.version != VERSION) {
+      ::munmap(data, size);
+      tools::logger()->warn("[FrameLogReader] Skip invalid segment {}", path);
+      break;
+    }
+    segments_.push_back({static_cast<char *>(data), size});
+  }
+
+  if (segments_.empty()) throw std::runtime_error("FrameLogReader: no segments in " + dir_);
+
+  if (!load_index()) {
+    build_index();
+    save_index();
+  }
+  tools::logger()->info(
+    "[FrameLogReader] {}: {} frames in {} segments", dir_, index_.size(), segments_.size());
+}
+
+FrameLogReader::~FrameLogReader()
+{
+  for (const auto & segment : segments_) ::munmap(segment.data, segment.size);
+}
+
+bool FrameLogReader::read(std::size_t i, Frame & frame)
+{
+  if (i >= index_.size()) return false;
+
+  const auto & entry = index_[i];
+  const auto * record = segments_[entry.segment].data + entry.offset;
+  RecordHeader header;
+  FrameInfo info;
+  std::memcpy(&header, record, sizeof(header));
+  std::memcpy(&info, record + sizeof(header), sizeof(info));
+  auto * data = segments_[entry.segment].data + entry.offset + sizeof(header) + sizeof(info);
+
+  frame.timestamp = timestamp(i);
+  frame.q = Eigen::Quaterniond(entry.q[0], entry.q[1], entry.q[2], entry.q[3]);
+
+  if (header.codec == Codec::JPEG) {
+    cv::Mat encoded(1, header.size - sizeof(info), CV_8UC1, data);
+    decoded_ = cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+    if (decoded_.empty()) {
+      tools::logger()->warn("[FrameLogReader] Failed to decode frame {}", i);
+      return false;
+    }
+    frame.img = decoded_;
+    return true;
+  }
+
+  if (header.codec == Codec::LZ4) {
+    buffer_.resize(header.raw_size - sizeof(info));
+    auto n = LZ4_decompress_safe(data, buffer_.data(), header.size - sizeof(info), buffer_.size());
+    if (n != int(buffer_.size())) {
+      tools::logger()->warn("[FrameLogReader] Failed to decompress frame {}", i);
+      return false;
+    }
+    data = buffer_.data();
+  }
+
+  frame.img = cv::Mat(info.rows, info.cols, info.type, data);
+  return true;
+}
+
+std::chrono::steady_clock::time_point FrameLogReader::timestamp(std::size_t i) const
+{
+  return std::chrono::steady_clock::time_point(
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::nanoseconds(index_[i].timestamp_ns)));
+}
+
+std::size_t FrameLogReader::find(std::chrono::steady_clock::time_point t) const
+{
+  auto it = std::lower_bound(
+    index_.begin(), index_.end(), to_ns(t),
+    [](const IndexEntry & entry, int64_t ns) { return entry.timestamp_ns < ns; });
+  return it - index_.begin();
+}
+
+std::pair<std::size_t, std::size_t> FrameLogReader::range(
+  std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1) const
+{
+  auto first = find(t0);
+  return {first, std::max(first, find(t1))};
+}
+
+bool FrameLogReader::cut(const std::string & dir, std::size_t first, std::size_t last) const
+{
+  last = std::min(last, index_.size());
+  if (first >= last) return false;
+  if (std::filesystem::exists(dir) && std::filesystem::equivalent(dir, dir_)) return false;
+  std::filesystem::create_directories(dir);
+
+  // 每个源段中的连续区间写为一个新段
+  uint32_t out_index = 0;
+  for (auto i = first; i < last;) {
+    auto segment = index_[i].segment;
+    auto j = i;
+    while (j + 1 < last && index_[j + 1].segment == segment) j++;
+
+    const auto * data = segments_[segment].data;
+    RecordHeader tail;
+    std::memcpy(&tail, data + index_[j].offset, sizeof(tail));
+    auto begin = index_[i].begin;
+    auto end = index_[j].offset + sizeof(tail) + aligned(tail.size);
+
+    SegmentHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    header.index = out_index;
+
+    std::ofstream file(dir + "/" + segment_name(out_index++), std::ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(data + begin, end - begin);
+    if (!file) return false;
+
+    i = j + 1;
+  }
+
+  // 覆盖已有录像时删除多余的段和过期的索引
+  while (std::filesystem::remove(dir + "/" + segment_name(out_index))) out_index++;
+  std::filesystem::remove(dir + "/" + INDEX_NAME);
+  return true;
+}
+
+bool FrameLogReader::load_index()
+{
+  std::ifstream file(dir_ + "/" + INDEX_NAME, std::ios::binary);
+  if (!file) return false;
+
+  IndexHeader header;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (
+    !file || std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+    header.version != VERSION || header.segments != segments_.size())
+    return false;
+
+  for (const auto & segment : segments_) {
+    uint64_t size;
+    file.read(reinterpret_cast<char *>(&size), sizeof(size));
+    if (!file || size != segment.size) return false;
+  }
+
+  index_.resize(header.frames);
+  file.read(reinterpret_cast<char *>(index_.data()), index_.size() * sizeof(IndexEntry));
+  if (!file) {
+    index_.clear();
+    return false;
+  }
+  return true;
+}
+
+// 只读取记录头，按size跳过负载
+void FrameLogReader::build_index()
+{
+  index_.clear();
+  double q[4] = {1, 0, 0, 0};
+  for (uint32_t s = 0; s < segments_.size(); s++) {
+    const auto & segment = segments_[s];
+    auto begin = uint64_t(sizeof(SegmentHeader));
+    for (auto pos = begin; pos + sizeof(RecordHeader) <= segment.size;) {
+      RecordHeader header;
+      std::memcpy(&header, segment.data + pos, sizeof(header));
+      auto end = pos + sizeof(header) + aligned(header.size);
+      if (header.magic != RECORD_MAGIC || end > segment.size) {
+        // 写入中断的段只保留完整的记录
+        tools::logger()->warn("[FrameLogReader] Truncated segment {} at {}", segment_name(s), pos);
+        break;
+      }
+
+      if (header.type == RecordType::IMU && header.size == sizeof(q))
+        std::memcpy(q, segment.data + pos + sizeof(header), sizeof(q));
+
+      if (header.type == RecordType::FRAME) {
+        IndexEntry entry{s, 0, begin, pos, header.timestamp_ns, {q[0], q[1], q[2], q[3]}};
+        index_.push_back(entry);
+        begin = end;
+      }
+      pos = end;
+    }
+  }
+}
+
+void FrameLogReader::save_index() const
+{
+  std::ofstream file(dir_ + "/" + INDEX_NAME, std::ios::binary);
+  if (!file) return;
+
+  IndexHeader header{};
+  std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  header.version = VERSION;
+  header.segments = segments_.size();
+  header.frames = index_.size();
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const auto & segment : segments_) {
+    uint64_t size = segment.size;
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  }
+  file.write(reinterpret_cast<const char *>(index_.data()), index_.size() * sizeof(IndexEntry));
+}
+
+}  // namespace tools
@@ -0,0 +1,252 @@
+#ifndef TOOLS__FRAME_LOG_HPP
+#define TOOLS__FRAME_LOG_HPP
+
+#include <Eigen/Geometry>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tools
+{
+// 分段二进制录像格式
+// 目录下依次为000000.flog、000001.flog...，每段以SegmentHeader开头，之后是首尾相接的记录
+// 每条记录为RecordHeader + 负载，按8字节对齐；记录不跨段
+namespace frame_log
+{
+constexpr char SEGMENT_MAGIC[4] = {'F', 'L', 'O', 'G'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t RECORD_MAGIC = 0x43524c46;  // "FLRC"
+constexpr std::size_t ALIGN = 8;
+
+enum class RecordType : uint16_t
+{
+  FRAME = 1,  // 负载为FrameInfo + 图像数据（按codec压缩）
+  IMU = 2,    // 负载为wxyz四元数
+  SIDE = 3,   // 负载为任意字节，如CAN帧、云台指令，channel由调用方约定
+};
+
+enum class Codec : uint16_t
+{
+  RAW = 0,
+  LZ4 = 1,
+  JPEG = 2,  // 有损，仅用于8位单通道或BGR图像，其他图像退回LZ4
+};
+
+struct SegmentHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t index;  // 段序号
+  uint32_t reserved;
+  int64_t system_ns;  // 打开该段时的system_clock，用于换算墙上时间
+  int64_t steady_ns;  // 同一时刻的steady_clock
+};
+
+struct RecordHeader
+{
+  uint32_t magic;
+  RecordType type;
+  Codec codec;
+  uint32_t size;      // 负载字节数（压缩后，不含对齐填充）
+  uint32_t raw_size;  // 解压后的字节数
+  uint16_t channel;   // 仅SIDE记录使用
+  uint16_t reserved;
+  uint32_t reserved2;
+  uint64_t seq;          // 所有记录统一递增，可由断档判断丢失
+  int64_t timestamp_ns;  // steady_clock
+};
+
+struct FrameInfo
+{
+  int32_t rows, cols, type;  // type为cv::Mat::type()
+  int32_t reserved;
+};
+
+static_assert(sizeof(SegmentHeader) % ALIGN == 0 && sizeof(RecordHeader) % ALIGN == 0);
+static_assert(sizeof(FrameInfo) % ALIGN == 0);
+
+inline std::size_t aligned(std::size_t size) { return (size + ALIGN - 1) / ALIGN * ALIGN; }
+
+inline int64_t to_ns(std::chrono::steady_clock::time_point t)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+inline std::string segment_name(uint32_t index) { return cv::format("%06u.flog", index); }
+
+// 帧索引，由FrameLogReader扫描各段记录头生成，缓存为录像目录下的index.fidx
+struct IndexEntry
+{
+  uint32_t segment;
+  uint32_t reserved;
+  uint64_t begin;   // 上一帧之后第一条记录的偏移，即属于该帧的IMU、旁路记录的起点
+  uint64_t offset;  // 该帧记录的偏移
+  int64_t timestamp_ns;
+  double q[4];  // 该帧之前最近的IMU记录，wxyz
+};
+
+}  // namespace frame_log
+
+// 缓冲区满时的处理方式
+enum class Overflow
+{
+  DROP_NEWEST,  // 丢弃新写入的记录，write_*从不等待
+  DROP_OLDEST,  // 丢弃最早的尚未压缩的记录，空间仍不足时等待正在压缩的记录写完
+  BLOCK,        // 等待直到有空间，压缩线程不降为SCHED_IDLE，仅用于离线转换等不能丢帧的场景
+};
+
+struct FrameLogOptions
+{
+  frame_log::Codec codec = frame_log::Codec::LZ4;
+  int jpeg_quality = 90;
+  int workers = 2;         // 压缩线程数
+  double cpu_quota = 1.0;  // 压缩线程合计最多占用的CPU核数，0表示不限制
+  Overflow overflow = Overflow::DROP_NEWEST;
+  std::size_t ring_size = std::size_t(256) << 20;   // 至少能容纳若干帧原始图像
+  std::size_t segment_size = std::size_t(1) << 30;  // 单个文件的大小上限，超过后切换到下一段
+};
+
+// 分段二进制录像的写入端，多个线程可同时写入
+// write_*只把原始数据拷贝进预先分配的环形缓冲区，不分配内存；缓冲区满时按Overflow处理并计数
+// 多个压缩线程按顺序领取记录并行压缩，再按原顺序以大块对齐写入（O_DIRECT，不支持时退回普通写入）
+// 压缩线程为SCHED_IDLE（BLOCK除外），并按cpu_quota限流，不与检测等线程争抢CPU
+// 构造时分配并触碰整个环形缓冲区，耗时与ring_size成正比，不应在实时线程中构造
+class FrameLogWriter
+{
+public:
+  struct Stats
+  {
+    uint64_t frames, imus, sides;  // 已写入文件
+    uint64_t dropped;              // 因缓冲区满丢弃的记录
+    uint64_t raw_bytes, file_bytes;
+    uint32_t segments;
+    double cpu_time;  // 压缩线程合计的CPU时间(s)
+  };
+
+  explicit FrameLogWriter(const std::string & dir, const FrameLogOptions & options = {});
+  ~FrameLogWriter();
+
+  bool write_frame(const cv::Mat & img, std::chrono::steady_clock::time_point t);
+  bool write_imu(const Eigen::Quaterniond & q, std::chrono::steady_clock::time_point t);
+  bool write_side(
+    uint16_t channel, const void * data, std::size_t size, std::chrono::steady_clock::time_point t);
+
+  const std::string & dir() const { return dir_; }
+  Stats stats() const;
+
+private:
+  // 压缩线程各自的缓冲
+  struct Encoder
+  {
+    std::vector<char> buffer;
+    unsigned char * jpeg = nullptr;  // 由libjpeg按需分配
+    unsigned long jpeg_size = 0;
+  };
+
+  const std::string dir_;
+  const FrameLogOptions options_;
+
+  // 环形缓冲区，[tail_, read_)已被压缩线程领取，[read_, head_)等待领取
+  // 三个游标均由mutex_保护；负载在领取后无锁读取，tail_越过后才可被覆盖
+  std::unique_ptr<char[]> ring_;
+  const std::size_t ring_size_;
+  uint64_t head_ = 0, read_ = 0, tail_ = 0;
+  uint64_t seq_ = 0;
+  bool quit_ = false;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;   // 有新记录
+  std::condition_variable turn_cv_;   // tail_前进，轮到下一条写入
+  std::condition_variable space_cv_;  // 有空间，仅BLOCK和DROP_OLDEST使用
+
+  std::atomic<uint64_t> frames_ = 0, imus_ = 0, sides_ = 0, dropped_ = 0;
+  std::atomic<uint64_t> raw_bytes_ = 0, file_bytes_ = 0, cpu_ns_ = 0;
+  std::atomic<uint32_t> segments_ = 0;
+
+  // 写入状态，只由tail_处的压缩线程访问
+  int fd_ = -1;
+  bool direct_ = false;
+  uint64_t segment_bytes_ = 0;  // 当前段的逻辑长度
+  char * staging_ = nullptr;    // 对齐的写缓冲
+  std::size_t staged_ = 0;
+
+  std::vector<std::thread> workers_;
+
+  bool push(
+    frame_log::RecordType type, uint16_t channel, std::chrono::steady_clock::time_point t,
+    const void * prefix, std::size_t prefix_size, const void * data, std::size_t size);
+  std::size_t skip_size(uint64_t pos) const;
+  void drop_oldest();
+  void work_loop();
+  const char * encode(
+    Encoder & encoder, frame_log::RecordHeader & header, const char * payload) const;
+  void write_record(const frame_log::RecordHeader & header, const char * payload);
+  void append(const void * data, std::size_t size);
+  void flush(bool final);
+  void open_segment();
+  void close_segment();
+};
+
+// 分段二进制录像的读取端
+// 各段整体mmap，按帧索引O(1)定位；未压缩的帧直接指向映射的内存，不拷贝
+// 映射为MAP_PRIVATE，在返回的图像上绘制只会触发写时复制，不会修改文件
+class FrameLogReader
+{
+public:
+  struct Frame
+  {
+    std::chrono::steady_clock::time_point timestamp;  // 录制时的steady_clock
+    Eigen::Quaterniond q;
+    cv::Mat img;  // 指向映射的内存或内部缓冲，下一次read()或析构后失效，需要保留时clone()
+  };
+
+  explicit FrameLogReader(const std::string & dir);
+  ~FrameLogReader();
+
+  FrameLogReader(const FrameLogReader &) = delete;
+  FrameLogReader & operator=(const FrameLogReader &) = delete;
+
+  std::size_t size() const { return index_.size(); }
+  const std::vector<frame_log::IndexEntry> & index() const { return index_; }
+
+  bool read(std::size_t i, Frame & frame);
+  std::chrono::steady_clock::time_point timestamp(std::size_t i) const;
+
+  // 第一个时间戳不早于t的帧，不存在时返回size()
+  std::size_t find(std::chrono::steady_clock::time_point t) const;
+
+  // 时间戳在[t0, t1)内的帧下标范围[first, last)
+  std::pair<std::size_t, std::size_t> range(
+    std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1) const;
+
+  // 把[first, last)帧及其间的IMU、旁路记录原样拷贝为新的录像，不解压、不重新编码
+  bool cut(const std::string & dir, std::size_t first, std::size_t last) const;
+
+private:
+  struct Segment
+  {
+    char * data;
+    std::size_t size;
+  };
+
+  const std::string dir_;
+  std::vector<Segment> segments_;
+  std::vector<frame_log::IndexEntry> index_;
+  std::vector<char> buffer_;  // 解压缓冲
+  cv::Mat decoded_;           // JPEG解码结果
+
+  bool load_index();
+  void build_index();
+  void save_index() const;
+};
+
+}  // namespace tools
+
+#endif  // TOOLS__FRAME_LOG_HPP
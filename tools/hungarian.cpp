@@ -0,0 +1,61 @@
+#include "hungarian.hpp"
+
+#include <limits>
+
+namespace tools
+{
+std::vector<int> hungarian(const Eigen::MatrixXd & cost, double unassigned_cost)
+{
+  const int rows = cost.rows();
+  const int cols = cost.cols();
+  std::vector<int> assignment(rows, -1);
+  if (rows == 0 || cols == 0) return assignment;
+
+  // 补成方阵，虚拟行/列代价为unassigned_cost，使任意配对都存在可行解
+  const int n = std::max(rows, cols);
+  Eigen::MatrixXd a = Eigen::MatrixXd::Constant(n, n, unassigned_cost);
+  a.topLeftCorner(rows, cols) = cost.cwiseMin(unassigned_cost);
+
+  // 基于势函数的Kuhn-Munkres，下标从1开始，0为哨兵
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> u(n + 1, 0), v(n + 1, 0);
+  std::vector<int> p(n + 1, 0), way(n + 1, 0);
+
+  for (int i = 1; i <= n; i++) {
+    p[0] = i;
+    int j0 = 0;
+    std::vector<double> minv(n + 1, inf);
+    std::vector<bool> used(n + 1, false);
+    do {
+      used[j0] = true;
+      int i0 = p[j0], j1 = 0;
+      double delta = inf;
+      for (int j = 1; j <= n; j++) {
+        if (used[j]) continue;
+        double cur = a(i0 - 1, j - 1) - u[i0] - v[j];
+        if (cur < minv[j]) minv[j] = cur, way[j] = j0;
+        if (minv[j] < delta) delta = minv[j], j1 = j;
+      }
+      for (int j = 0; j <= n; j++) {
+        if (used[j])
+          u[p[j]] += delta, v[j] -= delta;
+        else
+          minv[j] -= delta;
+      }
+      j0 = j1;
+    } while (p[j0] != 0);
+    do {
+      int j1 = way[j0];
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0);
+  }
+
+  for (int j = 1; j <= n; j++) {
+    int i = p[j] - 1, c = j - 1;
+    if (i < rows && c < cols && cost(i, c) < unassigned_cost) assignment[i] = c;
+  }
+  return assignment;
+}
+
+}  // namespace tools
@@ -0,0 +1,16 @@
+#ifndef TOOLS__HUNGARIAN_HPP
+#define TOOLS__HUNGARIAN_HPP
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace tools
+{
+// 匈牙利算法求解最小代价指派问题，O(n^2 m)
+// cost 行数n、列数m任意，代价大于等于unassigned_cost的配对视为不可行
+// 返回每一行对应的列下标，未指派的行为-1
+std::vector<int> hungarian(const Eigen::MatrixXd & cost, double unassigned_cost = 1e9);
+
+}  // namespace tools
+
+#endif  // TOOLS__HUNGARIAN_HPP
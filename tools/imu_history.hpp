@@ -0,0 +1,224 @@
+#ifndef TOOLS__IMU_HISTORY_HPP
+#define TOOLS__IMU_HISTORY_HPP
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace tools
+{
+struct ImuSample
+{
+  std::chrono::steady_clock::time_point t;
+  Eigen::Quaterniond q;
+  Eigen::Vector3d w;  // 机体系角速度，单位：rad/s
+};
+
+// 单写多读的定长IMU历史缓冲区
+// 写线程（CAN/串口）调用push，不加锁；读线程（视觉、录制、标定）调用at查询任意时刻的姿态
+// 每个槽位用seqlock保护，读线程只在槽位恰好被覆盖时重试，不会阻塞写线程
+template <std::size_t Capacity = 1024>
+class ImuHistory
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be 2^n");
+
+public:
+  struct Stats
+  {
+    uint64_t lookups;
+    uint64_t extrapolations;  // 查询时刻晚于最新样本的次数
+    uint64_t misses;          // 查询时刻早于最旧样本或缓冲区为空的次数
+    uint64_t retries;         // seqlock冲突重试次数
+    double mean_latency_us;
+    double max_latency_us;
+    double last_staleness_ms;  // 最近一次查询时最新样本距查询时刻的时间差
+  };
+
+  // max_extrapolation 允许用角速度外推的最长时间
+  explicit ImuHistory(
+    std::chrono::steady_clock::duration max_extrapolation = std::chrono::milliseconds(20))
+  : max_extrapolation_ns_(to_ns(max_extrapolation))
+  {
+  }
+
+  // 仅允许一个线程调用
+  void push(
+    std::chrono::steady_clock::time_point t, const Eigen::Quaterniond & q,
+    const Eigen::Vector3d & w = Eigen::Vector3d::Zero())
+  {
+    auto n = count_.load(std::memory_order_relaxed);
+    auto & slot = slots_[n & (Capacity - 1)];
+
+    auto seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.t.store(to_ns(t.time_since_epoch()), std::memory_order_relaxed);
+    auto qn = q.normalized();
+    const double data[7] = {qn.w(), qn.x(), qn.y(), qn.z(), w.x(), w.y(), w.z()};
+    for (int i = 0; i < 7; i++) slot.data[i].store(data[i], std::memory_order_relaxed);
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+    count_.store(n + 1, std::memory_order_release);
+  }
+
+  std::optional<ImuSample> latest() const
+  {
+    for (int attempt = 0; attempt < max_attempts; attempt++) {
+      auto n = count_.load(std::memory_order_acquire);
+      if (n == 0) return std::nullopt;
+      ImuSample sample;
+      if (read(n - 1, sample)) return sample;
+    }
+    return std::nullopt;
+  }
+
+  // 查询t时刻的姿态：两样本之间做SLERP，晚于最新样本时用角速度外推
+  std::optional<Eigen::Quaterniond> at(std::chrono::steady_clock::time_point t) const
+  {
+    auto start = std::chrono::steady_clock::now();
+    auto result = lookup(to_ns(t.time_since_epoch()));
+    auto latency_ns = to_ns(std::chrono::steady_clock::now() - start);
+
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    total_latency_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+    auto max = max_latency_ns_.load(std::memory_order_relaxed);
+    while (latency_ns > max &&
+           !max_latency_ns_.compare_exchange_weak(max, latency_ns, std::memory_order_relaxed)) {
+    }
+    return result;
+  }
+
+  Stats stats() const
+  {
+    Stats stats;
+    stats.lookups = lookups_.load(std::memory_order_relaxed);
+    stats.extrapolations = extrapolations_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.retries = retries_.load(std::memory_order_relaxed);
+    stats.mean_latency_us =
+      stats.lookups ? total_latency_ns_.load(std::memory_order_relaxed) / 1e3 / stats.lookups : 0;
+    stats.max_latency_us = max_latency_ns_.load(std::memory_order_relaxed) / 1e3;
+    stats.last_staleness_ms = last_staleness_ns_.load(std::memory_order_relaxed) / 1e6;
+    return stats;
+  }
+
+  std::size_t size() const
+  {
+    return std::min<std::size_t>(count_.load(std::memory_order_acquire), Capacity);
+  }
+
+private:
+  static constexpr int max_attempts = 8;
+
+  struct Slot
+  {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<int64_t> t{0};
+    std::array<std::atomic<double>, 7> data{};  // qw qx qy qz wx wy wz
+  };
+
+  std::array<Slot, Capacity> slots_;
+  alignas(64) std::atomic<uint64_t> count_{0};
+  const int64_t max_extrapolation_ns_;
+
+  mutable std::atomic<uint64_t> lookups_{0};
+  mutable std::atomic<uint64_t> extrapolations_{0};
+  mutable std::atomic<uint64_t> misses_{0};
+  mutable std::atomic<uint64_t> retries_{0};
+  mutable std::atomic<int64_t> total_latency_ns_{0};
+  mutable std::atomic<int64_t> max_latency_ns_{0};
+  mutable std::atomic<int64_t> last_staleness_ns_{0};
+
+  template <typename Duration>
+  static int64_t to_ns(Duration d)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+  }
+
+  // 读取第i个样本（逻辑下标），槽位被覆盖或正在写入时返回false
+  bool read(uint64_t i, ImuSample & sample) const
+  {
+    const auto & slot = slots_[i & (Capacity - 1)];
+    auto seq0 = slot.seq.load(std::memory_order_acquire);
+    if (seq0 & 1) return false;
+
+    auto t_ns = slot.t.load(std::memory_order_relaxed);
+    double data[7];
+    for (int k = 0; k < 7; k++) data[k] = slot.data[k].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto seq1 = slot.seq.load(std::memory_order_relaxed);
+    // 每个槽位第i次写入后seq为2*(i/Capacity+1)，据此同时排除被覆盖的情况
+    if (seq0 != seq1 || seq0 != 2 * (i / Capacity + 1)) return false;
+
+    sample.t = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(t_ns));
+    sample.q = Eigen::Quaterniond(data[0], data[1], data[2], data[3]);
+    sample.w = Eigen::Vector3d(data[4], data[5], data[6]);
+    return true;
+  }
+
+  std::optional<Eigen::Quaterniond> lookup(int64_t t_ns) const
+  {
+    for (int attempt = 0; attempt < max_attempts; attempt++) {
+      if (attempt > 0) retries_.fetch_add(1, std::memory_order_relaxed);
+
+      auto n = count_.load(std::memory_order_acquire);
+      if (n == 0) break;
+
+      // 预留一半容量，降低二分过程中旧样本被覆盖的概率
+      uint64_t lo = (n > Capacity / 2) ? n - Capacity / 2 : 0;
+      uint64_t hi = n - 1;
+
+      ImuSample newest, oldest;
+      if (!read(hi, newest) || !read(lo, oldest)) continue;
+
+      auto newest_ns = to_ns(newest.t.time_since_epoch());
+      last_staleness_ns_.store(t_ns - newest_ns, std::memory_order_relaxed);
+
+      // 晚于最新样本：用角速度外推
+      if (t_ns >= newest_ns) {
+        extrapolations_.fetch_add(1, std::memory_order_relaxed);
+        auto dt = std::min(t_ns - newest_ns, max_extrapolation_ns_) / 1e9;
+        auto angle = newest.w.norm() * dt;
+        if (angle < 1e-12) return newest.q;
+        return (newest.q * Eigen::AngleAxisd(angle, newest.w.normalized())).normalized();
+      }
+
+      // 早于最旧样本
+      if (t_ns < to_ns(oldest.t.time_since_epoch())) break;
+
+      // 二分查找满足 t(a) <= t < t(b) 的相邻样本
+      ImuSample a = oldest, b = newest;
+      bool ok = true;
+      while (hi - lo > 1) {
+        auto mid = lo + (hi - lo) / 2;
+        ImuSample sample;
+        if (!read(mid, sample)) {
+          ok = false;
+          break;
+        }
+        if (to_ns(sample.t.time_since_epoch()) <= t_ns)
+          lo = mid, a = sample;
+        else
+          hi = mid, b = sample;
+      }
+      if (!ok) continue;
+
+      auto span = to_ns(b.t - a.t);
+      auto k = span > 0 ? double(t_ns - to_ns(a.t.time_since_epoch())) / span : 0.0;
+      return a.q.slerp(k, b.q);
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+};
+
+}  // namespace tools
+
+#endif  // TOOLS__IMU_HISTORY_HPP
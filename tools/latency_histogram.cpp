@@ -0,0 +1,130 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "logger.hpp"
+#include "periodic_executor.hpp"
+#include "telemetry.hpp"
+
+namespace tools
+{
+int LatencyHistogram::index(int64_t ns)
+{
+  auto v = static_cast<uint64_t>(std::max<int64_t>(ns, 0));
+  if (v < SUB_COUNT) return static_cast<int>(v);
+
+  auto e = 63 - __builtin_clzll(v);  // 最高位，不小于SUB_BITS
+  if (e >= MAX_BITS) return BUCKET_NUM - 1;
+  auto sub = static_cast<int>(v >> (e - SUB_BITS)) - SUB_COUNT;
+  return SUB_COUNT * (e - SUB_BITS + 1) + sub;
+}
+
+int64_t LatencyHistogram::upper(int index)
+{
+  if (index < SUB_COUNT) return index;
+
+  auto shift = index / SUB_COUNT - 1;
+  auto sub = index % SUB_COUNT;
+  return (int64_t(SUB_COUNT + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t ns)
+{
+  buckets_[index(ns)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(ns, std::memory_order_relaxed);
+
+  auto max = max_.load(std::memory_order_relaxed);
+  while (ns > max && !max_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Summary LatencyHistogram::take()
+{
+  std::vector<uint64_t> counts(BUCKET_NUM);
+  for (int i = 0; i < BUCKET_NUM; i++)
+    counts[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+  return summarize(counts, sum_.exchange(0), max_.exchange(0));
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+  std::vector<uint64_t> counts(BUCKET_NUM);
+  for (int i = 0; i < BUCKET_NUM; i++) counts[i] = buckets_[i].load(std::memory_order_relaxed);
+  return summarize(counts, sum_.load(), max_.load());
+}
+
+LatencyHistogram::Summary LatencyHistogram::summarize(
+  const std::vector<uint64_t> & counts, int64_t sum, int64_t max)
+{
+  Summary summary{0, 0, 0, 0, 0, double(max)};
+  for (auto count : counts) summary.count += count;
+  if (summary.count == 0) return summary;
+
+  summary.mean = double(sum) / summary.count;
+
+  // 分位数取所在桶的上界，但不超过最大值
+  auto percentile = [&](double p) {
+    auto target = static_cast<uint64_t>(std::ceil(p * summary.count));
+    uint64_t cumulative = 0;
+    for (int i = 0; i < BUCKET_NUM; i++) {
+      cumulative += counts[i];
+      if (cumulative >= target) return std::min(double(upper(i)), summary.max);
+    }
+    return summary.max;
+  };
+  summary.p50 = percentile(0.5);
+  summary.p99 = percentile(0.99);
+  summary.p999 = percentile(0.999);
+  return summary;
+}
+
+LatencyMonitor::LatencyMonitor(std::chrono::milliseconds period, Telemetry * telemetry)
+: telemetry_(telemetry), executor_(std::make_unique<PeriodicExecutor>(period))
+{
+  thread_ = std::thread([this] { executor_->run([this] { report(); }); });
+}
+
+LatencyMonitor::~LatencyMonitor()
+{
+  executor_->stop();
+  if (thread_.joinable()) thread_.join();
+}
+
+LatencyHistogram & LatencyMonitor::histogram(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto & entry : entries_)
+    if (entry.name == name) return *entry.histogram;
+
+  Entry entry{name, std::make_unique<LatencyHistogram>(), {}};
+  if (telemetry_) {
+    entry.channels = {
+      telemetry_->channel(name + "_p50_ms"), telemetry_->channel(name + "_p99_ms"),
+      telemetry_->channel(name + "_p999_ms"), telemetry_->channel(name + "_max_ms")};
+  }
+  entries_.push_back(std::move(entry));
+  return *entries_.back().histogram;
+}
+
+void LatencyMonitor::report()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto t = std::chrono::steady_clock::now();
+  for (auto & entry : entries_) {
+    auto s = entry.histogram->take();
+    if (s.count == 0) continue;
+
+    tools::logger()->info(
+      "[Latency] {}: n={} mean={:.2f}ms p50={:.2f}ms p99={:.2f}ms p99.9={:.2f}ms max={:.2f}ms",
+      entry.name, s.count, s.mean / 1e6, s.p50 / 1e6, s.p99 / 1e6, s.p999 / 1e6, s.max / 1e6);
+
+    if (!telemetry_) continue;
+    telemetry_->record(entry.channels[0], s.p50 / 1e6, t);
+    telemetry_->record(entry.channels[1], s.p99 / 1e6, t);
+    telemetry_->record(entry.channels[2], s.p999 / 1e6, t);
+    telemetry_->record(entry.channels[3], s.max / 1e6, t);
+  }
+}
+
+}  // namespace tools
@@ -0,0 +1,89 @@
+#ifndef TOOLS__LATENCY_HISTOGRAM_HPP
+#define TOOLS__LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tools
+{
+// PeriodicExecutor使用LatencyHistogram，Telemetry又包含PeriodicExecutor，只做前置声明以避免循环包含
+class PeriodicExecutor;
+class Telemetry;
+
+// HDR式延迟直方图，单位ns
+// 小于2^SUB_BITS的值逐一计数，更大的值每个2的幂区间再等分为2^SUB_BITS个桶，相对误差不超过1/128
+// record()只做原子加，可由多个线程同时调用
+class LatencyHistogram
+{
+public:
+  static constexpr int SUB_BITS = 7;
+  static constexpr int MAX_BITS = 36;  // 约68s，更大的值计入最后一个桶
+
+  struct Summary
+  {
+    uint64_t count;
+    double mean, p50, p99, p999, max;  // ns
+  };
+
+  void record(int64_t ns);
+  void record(std::chrono::steady_clock::duration duration) { record(duration.count()); }
+
+  // 统计自上次take()以来的样本并清零，与record()并发时不丢失样本
+  Summary take();
+
+  // 统计全部样本，不清零
+  Summary summary() const;
+
+private:
+  static constexpr int SUB_COUNT = 1 << SUB_BITS;
+  static constexpr int BUCKET_NUM = SUB_COUNT * (MAX_BITS - SUB_BITS + 1);
+
+  std::array<std::atomic<uint64_t>, BUCKET_NUM> buckets_ = {};
+  std::atomic<int64_t> sum_ = 0;
+  std::atomic<int64_t> max_ = 0;
+
+  static int index(int64_t ns);
+  static int64_t upper(int index);  // 桶内最大的值
+  static Summary summarize(const std::vector<uint64_t> & counts, int64_t sum, int64_t max);
+};
+
+// 按名称管理一组延迟直方图，后台线程每个周期打印一次各直方图在该周期内的分位数
+// telemetry非空时同时以"<name>_p50_ms"等通道发送
+class LatencyMonitor
+{
+public:
+  explicit LatencyMonitor(
+    std::chrono::milliseconds period = std::chrono::seconds(1), Telemetry * telemetry = nullptr);
+  ~LatencyMonitor();
+
+  // 重复注册同名直方图返回同一个；会加锁，应在进入实时循环前调用
+  LatencyHistogram & histogram(const std::string & name);
+
+private:
+  struct Entry
+  {
+    std::string name;
+    std::unique_ptr<LatencyHistogram> histogram;
+    std::array<uint16_t, 4> channels;  // Telemetry::Channel
+  };
+
+  Telemetry * telemetry_;
+  std::mutex mutex_;
+  std::vector<Entry> entries_;
+
+  std::unique_ptr<PeriodicExecutor> executor_;
+  std::thread thread_;
+
+  void report();
+};
+
+}  // namespace tools
+
+#endif  // TOOLS__LATENCY_HISTOGRAM_HPP
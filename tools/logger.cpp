@@ -0,0 +1,52 @@
+#include "logger.hpp"
+
+#include <fmt/chrono.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <mutex>
+
+namespace tools
+{
+namespace
+{
+constexpr std::size_t QUEUE_SIZE = 8192;  // 异步队列可容纳的消息条数
+constexpr auto FLUSH_PERIOD = std::chrono::seconds(1);
+
+std::shared_ptr<spdlog::logger> logger_ = nullptr;
+std::once_flag once;
+
+void set_logger()
+{
+  auto file_name =
+    fmt::format("logs/{:%Y-%m-%d_%H-%M-%S}.log", fmt::localtime(std::time(nullptr)));
+  auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(file_name, true);
+  file_sink->set_level(spdlog::level::debug);
+
+  auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+  console_sink->set_level(spdlog::level::debug);
+
+  // 单个后台线程按顺序写入，队列满时覆盖最早的消息
+  spdlog::init_thread_pool(QUEUE_SIZE, 1);
+  logger_ = std::make_shared<spdlog::async_logger>(
+    "", spdlog::sinks_init_list{file_sink, console_sink}, spdlog::thread_pool(),
+    spdlog::async_overflow_policy::overrun_oldest);
+  logger_->set_level(spdlog::level::debug);
+  logger_->flush_on(spdlog::level::err);
+
+  // 作为默认logger注册，定期刷新，异常退出时最多丢失一个周期的日志
+  // 正常退出时由spdlog写完队列中剩余的消息
+  spdlog::set_default_logger(logger_);
+  spdlog::flush_every(FLUSH_PERIOD);
+}
+
+}  // namespace
+
+std::shared_ptr<spdlog::logger> logger()
+{
+  std::call_once(once, set_logger);
+  return logger_;
+}
+
+}  // namespace tools
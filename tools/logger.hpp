@@ -1,12 +1,108 @@
 #ifndef TOOLS__LOGGER_HPP
 #define TOOLS__LOGGER_HPP
 
+// 编译期的最低日志级别，取值同SPDLOG_LEVEL_*（trace为0，debug为1），默认为debug
+// 低于该级别的TOOLS_LOG_*宏和SPDLOG_LOGGER_*宏展开为空，参数不会被求值
+// 应由构建系统对每个目标同时定义TOOLS_LOG_ACTIVE_LEVEL和SPDLOG_ACTIVE_LEVEL，
+// 此处的定义只在本头文件先于spdlog被包含时生效
+#ifndef TOOLS_LOG_ACTIVE_LEVEL
+#define TOOLS_LOG_ACTIVE_LEVEL 1
+#endif
+
+#ifndef SPDLOG_ACTIVE_LEVEL
+#define SPDLOG_ACTIVE_LEVEL TOOLS_LOG_ACTIVE_LEVEL
+#endif
+
 #include <spdlog/spdlog.h>
 
+// spdlog先于本头文件被包含时SPDLOG_ACTIVE_LEVEL默认为info，TOOLS_LOG_DEBUG会被静默去除
+#if SPDLOG_ACTIVE_LEVEL != TOOLS_LOG_ACTIVE_LEVEL
+#error "SPDLOG_ACTIVE_LEVEL differs from TOOLS_LOG_ACTIVE_LEVEL, define both as compile definitions"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
 namespace tools
 {
+// 异步logger：调用线程只把消息放入环形队列，格式化后的写入和刷新由后台线程完成
+// 队列满时丢弃最早的消息，不阻塞调用线程
 std::shared_ptr<spdlog::logger> logger();
 
+// 单个调用点的限流，每秒最多放行per_second条
+// acquire()无锁，可由多个线程同时调用
+class LogLimiter
+{
+public:
+  explicit LogLimiter(int per_second) : per_second_(per_second) {}
+
+  // 返回-1表示本条应丢弃，否则返回上次放行之后丢弃的条数
+  int64_t acquire()
+  {
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+                 .count();
+    auto window = window_ns_.load(std::memory_order_relaxed);
+    if (now - window >= 1'000'000'000 && window_ns_.compare_exchange_strong(window, now))
+      count_.store(0, std::memory_order_relaxed);
+
+    if (count_.fetch_add(1, std::memory_order_relaxed) < per_second_)
+      return suppressed_.exchange(0, std::memory_order_relaxed);
+
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return -1;
+  }
+
+private:
+  const int per_second_;
+  std::atomic<int64_t> window_ns_ = 0;
+  std::atomic<int> count_ = 0;
+  std::atomic<int64_t> suppressed_ = 0;
+};
+
 }  // namespace tools
 
-#endif  // TOOLS__LOGGER_HPP
\ No newline at end of file
+// 限流的日志宏，每个调用点每秒最多输出n条，被丢弃的条数随下一条放行的日志输出
+#define TOOLS_LOG_LIMITED_(level, n, ...)                                            \
+  do {                                                                               \
+    static tools::LogLimiter tools_log_limiter_(n);                                  \
+    auto tools_log_suppressed_ = tools_log_limiter_.acquire();                       \
+    if (tools_log_suppressed_ < 0) break;                                            \
+    tools::logger()->log(level, __VA_ARGS__);                                        \
+    if (tools_log_suppressed_ > 0)                                                   \
+      tools::logger()->log(level, "({} similar suppressed)", tools_log_suppressed_); \
+  } while (0)
+
+#define TOOLS_LOG_NOOP_() \
+  do {                    \
+  } while (0)
+
+// 不限流的调试日志，用于每帧都会执行的调用点：关闭时在编译期去除，运行时级别高于debug时不格式化
+#define TOOLS_LOG_DEBUG(...) SPDLOG_LOGGER_DEBUG(tools::logger(), __VA_ARGS__)
+
+#if TOOLS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define TOOLS_LOG_DEBUG_LIMITED(n, ...) TOOLS_LOG_LIMITED_(spdlog::level::debug, n, __VA_ARGS__)
+#else
+#define TOOLS_LOG_DEBUG_LIMITED(n, ...) TOOLS_LOG_NOOP_()
+#endif
+
+#if TOOLS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define TOOLS_LOG_INFO_LIMITED(n, ...) TOOLS_LOG_LIMITED_(spdlog::level::info, n, __VA_ARGS__)
+#else
+#define TOOLS_LOG_INFO_LIMITED(n, ...) TOOLS_LOG_NOOP_()
+#endif
+
+#if TOOLS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define TOOLS_LOG_WARN_LIMITED(n, ...) TOOLS_LOG_LIMITED_(spdlog::level::warn, n, __VA_ARGS__)
+#else
+#define TOOLS_LOG_WARN_LIMITED(n, ...) TOOLS_LOG_NOOP_()
+#endif
+
+#if TOOLS_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define TOOLS_LOG_ERROR_LIMITED(n, ...) TOOLS_LOG_LIMITED_(spdlog::level::err, n, __VA_ARGS__)
+#else
+#define TOOLS_LOG_ERROR_LIMITED(n, ...) TOOLS_LOG_NOOP_()
+#endif
+
+#endif  // TOOLS__LOGGER_HPP
@@ -29,6 +29,12 @@ Eigen::Matrix3d rotation_matrix(const Eigen::Vector3d & ypr);
 // ypd为yaw、pitch、distance的缩写
 Eigen::Vector3d xyz2ypd(const Eigen::Vector3d & xyz);
 
+// 批量直角坐标系转球坐标系，输入输出均为长度n的数组
+// 使用simd_atan2，循环可向量化，与逐个调用xyz2ypd的误差在1e-15量级
+void xyz2ypd(
+  const double * x, const double * y, const double * z, double * yaw, double * pitch,
+  double * distance, int n);
+
 // 直角坐标系转球坐标系转换函数对xyz的雅可比矩阵
 Eigen::MatrixXd xyz2ypd_jacobian(const Eigen::Vector3d & xyz);
 
@@ -0,0 +1,20 @@
+#include <cmath>
+
+#include "math_tools.hpp"
+#include "simd_math.hpp"
+
+namespace tools
+{
+void xyz2ypd(
+  const double * x, const double * y, const double * z, double * yaw, double * pitch,
+  double * distance, int n)
+{
+  for (int i = 0; i < n; i++) {
+    auto d_xy = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+    yaw[i] = simd_atan2(y[i], x[i]);
+    pitch[i] = simd_atan2(z[i], d_xy);
+    distance[i] = std::sqrt(d_xy * d_xy + z[i] * z[i]);
+  }
+}
+
+}  // namespace tools
@@ -0,0 +1,125 @@
+#include "periodic_executor.hpp"
+
+#include <fmt/format.h>
+#include <pthread.h>  // pthread_setschedparam, pthread_setaffinity_np
+#include <sched.h>    // SCHED_FIFO, CPU_SET
+#include <time.h>     // clock_nanosleep
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#include "logger.hpp"
+
+namespace tools
+{
+namespace
+{
+int64_t to_ns(const timespec & ts) { return ts.tv_sec * 1'000'000'000LL + ts.tv_nsec; }
+
+timespec to_timespec(int64_t ns) { return {ns / 1'000'000'000LL, ns % 1'000'000'000LL}; }
+
+int64_t now_ns()
+{
+  timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return to_ns(ts);
+}
+
+}  // namespace
+
+PeriodicExecutor::PeriodicExecutor(std::chrono::nanoseconds period, int priority, int cpu)
+: period_(period), priority_(priority), cpu_(cpu)
+{
+}
+
+void PeriodicExecutor::run(const std::function<void()> & task)
+{
+  setup_thread();
+
+  auto period = period_.count();
+  auto deadline = now_ns() + period;
+  auto last_wake = -1LL;
+
+  while (!quit_) {
+    auto target = deadline;
+    auto ts = to_timespec(target);
+    while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+
+    auto wake = now_ns();
+    task();
+    auto done = now_ns();
+
+    // 任务结束时已过下一截止时间，跳到下一个未来的截止时间
+    uint64_t skipped = 0;
+    deadline = target + period;
+    if (done >= deadline) {
+      skipped = (done - deadline) / period + 1;
+      deadline += skipped * period;
+    }
+
+    cycles_.fetch_add(1, std::memory_order_relaxed);
+    jitter_ns_.record(wake - target);
+    last_jitter_us_.store((wake - target) * 1e-3, std::memory_order_relaxed);
+    if (last_wake >= 0) {
+      period_ns_.record(wake - last_wake);
+      last_period_us_.store((wake - last_wake) * 1e-3, std::memory_order_relaxed);
+    }
+    if (skipped > 0) {
+      overruns_.fetch_add(1, std::memory_order_relaxed);
+      skipped_.fetch_add(skipped, std::memory_order_relaxed);
+    }
+    last_wake = wake;
+  }
+}
+
+void PeriodicExecutor::stop() { quit_ = true; }
+
+PeriodicExecutor::Stats PeriodicExecutor::stats() const
+{
+  return {
+    cycles_.load(std::memory_order_relaxed),
+    overruns_.load(std::memory_order_relaxed),
+    skipped_.load(std::memory_order_relaxed),
+    last_period_us(),
+    last_jitter_us(),
+    period_ns_.summary(),
+    jitter_ns_.summary()};
+}
+
+std::string PeriodicExecutor::summary() const
+{
+  auto s = stats();
+  return fmt::format(
+    "{} cycles, {} overruns ({} skipped), period mean {:.1f}us p99 {:.1f}us max {:.1f}us, "
+    "jitter mean {:.1f}us p99 {:.1f}us max {:.1f}us",
+    s.cycles, s.overruns, s.skipped, s.period.mean / 1e3, s.period.p99 / 1e3, s.period.max / 1e3,
+    s.jitter.mean / 1e3, s.jitter.p99 / 1e3, s.jitter.max / 1e3);
+}
+
+// 调度策略和CPU绑定只作用于调用run的线程，失败时（如没有CAP_SYS_NICE）仅警告
+void PeriodicExecutor::setup_thread() const
+{
+  if (priority_ > 0) {
+    sched_param param{};
+    param.sched_priority = priority_;
+    auto ret = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param);
+    if (ret != 0)
+      logger()->warn(
+        "[PeriodicExecutor] Failed to set SCHED_FIFO {}: {}", priority_, std::strerror(ret));
+  }
+
+  if (cpu_ >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu_, &cpus);
+    auto ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+    if (ret != 0)
+      logger()->warn(
+        "[PeriodicExecutor] Failed to pin to CPU {}: {}", cpu_, std::strerror(ret));
+  }
+}
+
+}  // namespace tools
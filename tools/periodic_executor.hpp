@@ -0,0 +1,69 @@
+#ifndef TOOLS__PERIODIC_EXECUTOR_HPP
+#define TOOLS__PERIODIC_EXECUTOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "latency_histogram.hpp"
+
+namespace tools
+{
+// 按绝对截止时间周期执行任务的循环
+// 截止时间由clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)等待，周期不随任务耗时和调度噪声漂移
+// 任务超过一个周期时记为overrun，错过的周期直接跳过，不会连续补执行
+// 适用于plan线程、云台/C板发送和plotter等固定频率的循环
+class PeriodicExecutor
+{
+public:
+  struct Stats
+  {
+    uint64_t cycles;
+    uint64_t overruns;  // 任务结束时已过下一截止时间的次数
+    uint64_t skipped;   // 因overrun跳过的周期数
+    double last_period_us;
+    double last_jitter_us;
+    LatencyHistogram::Summary period;  // 相邻两次唤醒的间隔，单位：ns
+    LatencyHistogram::Summary jitter;  // 唤醒时刻晚于截止时间的量，单位：ns
+  };
+
+  // priority SCHED_FIFO优先级(1~99)，0表示不修改调度策略
+  // cpu 绑定的CPU编号，-1表示不绑定
+  explicit PeriodicExecutor(std::chrono::nanoseconds period, int priority = 0, int cpu = -1);
+
+  // 在调用线程中阻塞运行task，直到stop()被调用
+  void run(const std::function<void()> & task);
+  void stop();
+
+  std::chrono::nanoseconds period() const { return period_; }
+  Stats stats() const;
+  std::string summary() const;
+
+  // 无锁读取最近一个周期的统计，可在任务内每周期调用
+  double last_period_us() const { return last_period_us_.load(std::memory_order_relaxed); }
+  double last_jitter_us() const { return last_jitter_us_.load(std::memory_order_relaxed); }
+  uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+
+private:
+  const std::chrono::nanoseconds period_;
+  const int priority_;
+  const int cpu_;
+  std::atomic<bool> quit_ = false;
+
+  // 统计均为原子变量，run中不加锁
+  std::atomic<uint64_t> cycles_ = 0;
+  std::atomic<uint64_t> overruns_ = 0;
+  std::atomic<uint64_t> skipped_ = 0;
+  std::atomic<double> last_period_us_ = 0.0;
+  std::atomic<double> last_jitter_us_ = 0.0;
+  LatencyHistogram period_ns_;
+  LatencyHistogram jitter_ns_;
+
+  void setup_thread() const;
+};
+
+}  // namespace tools
+
+#endif  // TOOLS__PERIODIC_EXECUTOR_HPP
@@ -0,0 +1,60 @@
+#ifndef TOOLS__RECORDER_HPP
+#define TOOLS__RECORDER_HPP
+
+#include <Eigen/Geometry>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <thread>
+
+#include "frame_log.hpp"
+
+namespace tools
+{
+// 录制图像、IMU姿态及任意旁路数据到records/<启动时间>/下的分段二进制录像，格式见frame_log.hpp
+// 默认LZ4无损压缩，压缩线程数、JPEG有损压缩、缓冲区满时的处理方式及CPU占用上限见FrameLogOptions
+// 第一次record时才在后台线程中创建目录、缓冲区和压缩线程，从未录制时不产生空录像
+// 创建完成前的记录被丢弃，调用线程不等待
+// 用于实时线程，不接受Overflow::BLOCK
+class Recorder
+{
+public:
+  // fps为0时录制每一帧，否则按fps降采样
+  explicit Recorder(double fps = 0, const FrameLogOptions & options = {});
+  ~Recorder();
+
+  void record(
+    const cv::Mat & img, const Eigen::Quaterniond & q,
+    const std::chrono::steady_clock::time_point & timestamp);
+
+  // 旁路数据，如CAN帧、云台指令，channel由调用方约定
+  void record(
+    uint16_t channel, const void * data, std::size_t size,
+    const std::chrono::steady_clock::time_point & timestamp);
+
+  const std::string & path() const { return path_; }
+  FrameLogWriter::Stats stats() const;
+
+private:
+  double fps_;
+  const std::string path_;
+  const FrameLogOptions options_;
+  std::chrono::steady_clock::time_point last_time_;
+
+  // 图像和旁路数据可能来自不同线程，由once_flag保证只创建一次
+  std::once_flag init_;
+  std::thread init_thread_;
+  std::unique_ptr<FrameLogWriter> writer_;
+  std::atomic<FrameLogWriter *> ready_ = nullptr;
+
+  // 尚未创建完成时返回nullptr
+  FrameLogWriter * writer();
+};
+
+}  // namespace tools
+
+#endif  // TOOLS__RECORDER_HPP
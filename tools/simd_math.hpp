@@ -0,0 +1,50 @@
+#ifndef TOOLS__SIMD_MATH_HPP
+#define TOOLS__SIMD_MATH_HPP
+
+#include <cmath>
+
+namespace tools
+{
+// 无分支的atan2，与std::atan2的误差在1e-15量级
+// 只含四则运算、sqrt、fabs和条件选择，批量处理的循环可由编译器向量化（-O3），std::atan2无法向量化
+// 有理逼近系数来自Cephes的atan.c
+inline double simd_atan2(double y, double x)
+{
+  constexpr double PI = 3.14159265358979323846;
+  constexpr double TAN_PI_8 = 0.41421356237309504880;
+
+  auto ax = std::fabs(x);
+  auto ay = std::fabs(y);
+  auto max = ax > ay ? ax : ay;
+  auto min = ax > ay ? ay : ax;
+
+  // 1. 缩到[0, 1]，再缩到[-tan(pi/8), tan(pi/8)]
+  auto t = max > 0 ? min / max : 0.0;
+  auto reduce = t > TAN_PI_8;
+  t = reduce ? (t - 1) / (t + 1) : t;
+
+  // 2. atan(t) = t + t * z * P(z) / Q(z), z = t^2
+  auto z = t * t;
+  auto p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z -
+             7.500855792314704667340e1) *
+              z -
+            1.228866684490136173410e2) *
+             z -
+           6.485021904942025371773e1;
+  auto q = ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z +
+             4.328810604912902668951e2) *
+              z +
+            4.853903996359136964868e2) *
+             z +
+           1.945506571482613964425e2;
+  auto r = t + t * z * p / q + (reduce ? PI / 4 : 0.0);
+
+  // 3. 还原到所在象限
+  r = ay > ax ? PI / 2 - r : r;
+  r = std::signbit(x) ? PI - r : r;
+  return std::copysign(r, y);
+}
+
+}  // namespace tools
+
+#endif  // TOOLS__SIMD_MATH_HPP
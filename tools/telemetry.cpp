@@ -0,0 +1,318 @@
+#include "telemetry.hpp"
+
+#include <arpa/inet.h>   // htons, inet_addr
+#include <sys/socket.h>  // socket, sendto
+#include <unistd.h>      // close
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "logger.hpp"
+
+namespace tools
+{
+namespace
+{
+using namespace telemetry;
+
+constexpr std::size_t MAX_SAMPLES = (MAX_DATAGRAM - sizeof(DatagramHeader)) / sizeof(Sample);
+constexpr auto SCHEMA_PERIOD = std::chrono::seconds(1);  // 接收端中途启动时也能拿到通道名
+
+std::atomic<uint64_t> next_id{1};
+
+int64_t to_ns(std::chrono::steady_clock::time_point t)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+}  // namespace
+
+// 单生产者（所属线程）单消费者（后台线程）
+struct Telemetry::Ring
+{
+  static constexpr std::size_t SIZE = 4096;
+
+  struct Entry
+  {
+    int64_t t_ns;
+    double value;
+    Channel channel;
+  };
+
+  std::array<Entry, SIZE> entries;
+  alignas(64) std::atomic<uint64_t> head = 0;
+  alignas(64) std::atomic<uint64_t> tail = 0;
+  std::atomic<uint64_t> dropped = 0;
+};
+
+Telemetry::Telemetry(
+  const std::string & host, uint16_t port, const std::string & path,
+  std::chrono::milliseconds period)
+: id_(next_id++), datagram_(MAX_DATAGRAM), executor_(period)
+{
+  socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  destination_.sin_family = AF_INET;
+  destination_.sin_port = ::htons(port);
+  destination_.sin_addr.s_addr = ::inet_addr(host.c_str());
+
+  if (!path.empty()) {
+    file_.open(path, std::ios::binary);
+    if (!file_) tools::logger()->warn("[Telemetry] Failed to open {}", path);
+  }
+
+  thread_ = std::thread([this] { executor_.run([this] { flush(); }); });
+}
+
+Telemetry::~Telemetry()
+{
+  executor_.stop();
+  if (thread_.joinable()) thread_.join();
+  flush();
+  ::close(socket_);
+}
+
+Telemetry::Channel Telemetry::channel(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(name);
+  if (it != ids_.end()) return it->second;
+
+  Channel id = names_.size();
+  names_.push_back(name);
+  ids_[name] = id;
+  schema_dirty_ = true;
+  return id;
+}
+
+void Telemetry::record(Channel channel, double value, std::chrono::steady_clock::time_point t)
+{
+  auto * r = ring();
+  auto head = r->head.load(std::memory_order_relaxed);
+  if (head - r->tail.load(std::memory_order_acquire) >= Ring::SIZE) {
+    r->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  r->entries[head % Ring::SIZE] = {to_ns(t), value, channel};
+  r->head.store(head + 1, std::memory_order_release);
+}
+
+Telemetry::Stats Telemetry::stats() const { return {samples_, dropped(), datagrams_, bytes_}; }
+
+// 每个线程第一次调用时注册自己的环形缓冲区，之后只查线程局部缓存
+// 缓存条目随实例析构而过期，在本线程下一次注册时清除
+Telemetry::Ring * Telemetry::ring()
+{
+  struct Cached
+  {
+    uint64_t id;
+    std::weak_ptr<Ring> owner;
+    Ring * ring;
+  };
+  thread_local std::vector<Cached> cache;
+  for (const auto & c : cache)
+    if (c.id == id_) return c.ring;
+
+  cache.erase(
+    std::remove_if(cache.begin(), cache.end(), [](const Cached & c) { return c.owner.expired(); }),
+    cache.end());
+
+  // 不用make_shared，使缓冲区内存在实例析构时即释放，而非等到所有weak_ptr销毁
+  std::shared_ptr<Ring> ring(new Ring);
+  std::lock_guard<std::mutex> lock(mutex_);
+  rings_.push_back(ring);
+  cache.push_back({id_, ring, ring.get()});
+  return ring.get();
+}
+
+uint64_t Telemetry::dropped() const
+{
+  uint64_t sum = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto & ring : rings_) sum += ring->dropped.load(std::memory_order_relaxed);
+  return sum;
+}
+
+void Telemetry::flush()
+{
+  std::vector<Ring *> rings;
+  bool schema;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & ring : rings_) rings.push_back(ring.get());
+    schema = schema_dirty_;
+    schema_dirty_ = false;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (schema || now - last_schema_ > SCHEMA_PERIOD) {
+    send_schema();
+    last_schema_ = now;
+  }
+
+  // 各缓冲区内时间戳递增，每次取出最早的一个样本，使输出整体按时间排序
+  std::vector<uint64_t> tails, heads;
+  for (auto * r : rings) {
+    tails.push_back(r->tail.load(std::memory_order_relaxed));
+    heads.push_back(r->head.load(std::memory_order_acquire));
+  }
+
+  auto * samples = reinterpret_cast<Sample *>(datagram_.data() + sizeof(DatagramHeader));
+  uint16_t count = 0;
+  int64_t base_ns = 0;
+  while (true) {
+    const Ring::Entry * next = nullptr;
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < rings.size(); i++) {
+      if (tails[i] == heads[i]) continue;
+      const auto & entry = rings[i]->entries[tails[i] % Ring::SIZE];
+      if (!next || entry.t_ns < next->t_ns) {
+        next = &entry;
+        k = i;
+      }
+    }
+    if (!next) break;
+
+    const auto entry = *next;
+    tails[k]++;
+
+    auto dt_ns = entry.t_ns - base_ns;
+    if (
+      count > 0 && (dt_ns < std::numeric_limits<int32_t>::min() ||
+                    dt_ns > std::numeric_limits<int32_t>::max())) {
+      send(Kind::DATA, count, sizeof(DatagramHeader) + count * sizeof(Sample), base_ns);
+      count = 0;
+    }
+    if (count == 0) {
+      base_ns = entry.t_ns;
+      dt_ns = 0;
+    }
+
+    Sample sample{int32_t(dt_ns), entry.channel, 0, entry.value};
+    std::memcpy(&samples[count++], &sample, sizeof(sample));
+    if (count == MAX_SAMPLES) {
+      send(Kind::DATA, count, MAX_DATAGRAM, base_ns);
+      count = 0;
+    }
+  }
+  if (count > 0) send(Kind::DATA, count, sizeof(DatagramHeader) + count * sizeof(Sample), base_ns);
+
+  // 样本全部打包后才归还空间，生产者不会覆盖尚未读取的条目
+  for (std::size_t i = 0; i < rings.size(); i++)
+    rings[i]->tail.store(tails[i], std::memory_order_release);
+}
+
+void Telemetry::send_schema()
+{
+  std::vector<std::string> names;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    names = names_;
+  }
+
+  auto size = sizeof(DatagramHeader);
+  uint16_t count = 0;
+  for (std::size_t id = 0; id < names.size(); id++) {
+    auto length = std::min<std::size_t>(names[id].size(), 255);
+    if (size + 3 + length > MAX_DATAGRAM) {
+      send(Kind::SCHEMA, count, size, 0);
+      size = sizeof(DatagramHeader);
+      count = 0;
+    }
+
+    auto * p = datagram_.data() + size;
+    uint16_t channel = id;
+    std::memcpy(p, &channel, sizeof(channel));
+    p[2] = static_cast<char>(length);
+    std::memcpy(p + 3, names[id].data(), length);
+    size += 3 + length;
+    count++;
+  }
+  if (count > 0) send(Kind::SCHEMA, count, size, 0);
+}
+
+void Telemetry::send(Kind kind, uint16_t count, std::size_t size, int64_t base_ns)
+{
+  DatagramHeader header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.kind = kind;
+  header.count = count;
+  header.size = size;
+  header.seq = seq_++;
+  header.dropped = dropped();
+  header.base_ns = base_ns;
+  std::memcpy(datagram_.data(), &header, sizeof(header));
+
+  ::sendto(
+    socket_, datagram_.data(), size, 0, reinterpret_cast<sockaddr *>(&destination_),
+    sizeof(destination_));
+  if (file_.is_open()) file_.write(datagram_.data(), size);
+
+  if (kind == Kind::DATA) samples_ += count;
+  datagrams_++;
+  bytes_ += size;
+}
+
+std::vector<nlohmann::json> TelemetryDecoder::decode(const void * data, std::size_t size)
+{
+  std::vector<nlohmann::json> result;
+
+  DatagramHeader header;
+  if (size < sizeof(header)) return result;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != MAGIC || header.version != VERSION || header.size > size) return result;
+
+  if (synced_ && header.seq > next_seq_) lost_ += header.seq - next_seq_;
+  next_seq_ = header.seq + 1;
+  synced_ = true;
+  dropped_ = header.dropped;
+
+  const auto * p = static_cast<const char *>(data) + sizeof(header);
+  const auto * end = static_cast<const char *>(data) + header.size;
+
+  if (header.kind == Kind::SCHEMA) {
+    for (int i = 0; i < header.count && p + 3 <= end; i++) {
+      Telemetry::Channel channel;
+      std::memcpy(&channel, p, sizeof(channel));
+      auto length = static_cast<uint8_t>(p[2]);
+      if (p + 3 + length > end) break;
+      names_[channel] = std::string(p + 3, length);
+      p += 3 + length;
+    }
+    return result;
+  }
+
+  for (int i = 0; i < header.count && p + sizeof(Sample) <= end; i++, p += sizeof(Sample)) {
+    Sample sample;
+    std::memcpy(&sample, p, sizeof(sample));
+    auto t_ns = header.base_ns + sample.dt_ns;
+    if (!started_) {
+      t0_ns_ = t_ns;
+      started_ = true;
+    }
+
+    if (pending_.is_null() || t_ns != pending_ns_) {
+      if (!pending_.is_null()) result.push_back(std::move(pending_));
+      pending_ = nlohmann::json::object();
+      pending_["t"] = (t_ns - t0_ns_) * 1e-9;
+      pending_ns_ = t_ns;
+    }
+
+    auto it = names_.find(sample.channel);
+    auto name = it != names_.end() ? it->second : "#" + std::to_string(sample.channel);
+    pending_[name] = sample.value;
+  }
+  return result;
+}
+
+std::vector<nlohmann::json> TelemetryDecoder::flush()
+{
+  std::vector<nlohmann::json> result;
+  if (!pending_.is_null()) result.push_back(std::move(pending_));
+  pending_ = nullptr;
+  return result;
+}
+
+}  // namespace tools
@@ -0,0 +1,157 @@
+#ifndef TOOLS__TELEMETRY_HPP
+#define TOOLS__TELEMETRY_HPP
+
+#include <netinet/in.h>  // sockaddr_in
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "periodic_executor.hpp"
+
+namespace tools
+{
+// 二进制遥测格式：每个UDP数据报（或文件中的每一段）以DatagramHeader开头
+// DATA之后是count个Sample；SCHEMA之后是count个{uint16 id, uint8 长度, 名称}，用于解码时还原通道名
+namespace telemetry
+{
+constexpr uint32_t MAGIC = 0x314d4c54;  // "TLM1"
+constexpr uint8_t VERSION = 1;
+constexpr std::size_t MAX_DATAGRAM = 1472;  // 以太网MTU内不分片
+
+enum class Kind : uint8_t
+{
+  DATA = 0,
+  SCHEMA = 1,
+};
+
+#pragma pack(push, 1)
+struct DatagramHeader
+{
+  uint32_t magic;
+  uint8_t version;
+  Kind kind;
+  uint16_t count;
+  uint16_t size;  // 整个数据报的字节数
+  uint16_t reserved;
+  uint32_t seq;      // 数据报序号，接收端据此统计丢包
+  uint32_t dropped;  // 发送端累计因环形缓冲区满丢弃的样本数
+  int64_t base_ns;   // DATA中样本时间戳的基准(steady_clock)
+};
+
+struct Sample
+{
+  int32_t dt_ns;  // 相对base_ns，超出范围时另起一个数据报
+  uint16_t channel;
+  uint16_t reserved;
+  double value;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(DatagramHeader) == 28 && sizeof(Sample) == 16);
+
+}  // namespace telemetry
+
+// 替代Plotter的遥测通道
+// 通道名只在注册时传递一次，之后按id记录数值
+// record()写入调用线程独有的无锁环形缓冲区，不分配、不加锁，满时丢弃并计数
+// 后台线程周期性地按时间戳归并各缓冲区中的样本，打包为二进制UDP数据报发送，并可同时写入文件
+// 用telemetry_bridge解码后以JSON转发给原有的绘图工具
+class Telemetry
+{
+public:
+  using Channel = uint16_t;
+
+  struct Stats
+  {
+    uint64_t samples;  // 已发送的样本数
+    uint64_t dropped;  // 因环形缓冲区满丢弃的样本数
+    uint64_t datagrams;
+    uint64_t bytes;
+  };
+
+  // path非空时同时写入该文件
+  explicit Telemetry(
+    const std::string & host = "127.0.0.1", uint16_t port = 9871, const std::string & path = "",
+    std::chrono::milliseconds period = std::chrono::milliseconds(10));
+  ~Telemetry();
+
+  // 重复注册同名通道返回同一id；会加锁，应在进入实时循环前调用
+  Channel channel(const std::string & name);
+
+  // 同一时刻的多个数值应传入同一t，解码时合并为一个JSON对象
+  void record(
+    Channel channel, double value,
+    std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now());
+
+  Stats stats() const;
+
+private:
+  struct Ring;
+
+  const uint64_t id_;  // 区分先后创建的实例，作为线程局部环形缓冲区缓存的键
+  int socket_;
+  sockaddr_in destination_;
+  std::ofstream file_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<Ring>> rings_;  // 线程局部缓存持有weak_ptr，实例析构后即过期
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, Channel> ids_;
+  bool schema_dirty_ = true;
+
+  // 以下只由后台线程访问
+  std::vector<char> datagram_;
+  uint32_t seq_ = 0;
+  std::chrono::steady_clock::time_point last_schema_;
+
+  std::atomic<uint64_t> samples_ = 0, datagrams_ = 0, bytes_ = 0;
+
+  PeriodicExecutor executor_;
+  std::thread thread_;
+
+  Ring * ring();
+  uint64_t dropped() const;
+  void flush();
+  void send_schema();
+  void send(telemetry::Kind kind, uint16_t count, std::size_t size, int64_t base_ns);
+};
+
+// 把二进制数据报还原为与Plotter相同的JSON，"t"为相对第一个样本的秒数
+class TelemetryDecoder
+{
+public:
+  // 时间戳相同的连续样本合并为一个JSON对象，可能跨越数据报，因此最后一个对象留到下次返回
+  // SCHEMA只更新通道名
+  std::vector<nlohmann::json> decode(const void * data, std::size_t size);
+
+  // 返回留存的最后一个对象，用于结束解码时
+  std::vector<nlohmann::json> flush();
+
+  uint64_t lost() const { return lost_; }        // 按seq推断丢失的数据报数
+  uint64_t dropped() const { return dropped_; }  // 发送端报告的丢弃样本数
+
+private:
+  std::unordered_map<Telemetry::Channel, std::string> names_;
+  int64_t t0_ns_ = 0;
+  bool started_ = false;  // 已收到第一个样本
+  bool synced_ = false;   // 已收到第一个数据报
+  nlohmann::json pending_;
+  int64_t pending_ns_ = 0;
+  uint32_t next_seq_ = 0;
+  uint64_t lost_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+}  // namespace tools
+
+#endif  // TOOLS__TELEMETRY_HPP
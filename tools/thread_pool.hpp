@@ -63,7 +63,7 @@ public:
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (item.id < current_id_) {
-      tools::logger()->warn("small id");
+      TOOLS_LOG_WARN_LIMITED(1, "small id {} < {}", item.id, current_id_);
       return;
     }
 
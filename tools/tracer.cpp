@@ -0,0 +1,170 @@
+#include "tracer.hpp"
+
+#include <fmt/format.h>
+#include <sys/syscall.h>  // SYS_gettid
+#include <unistd.h>       // syscall, getpid
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "logger.hpp"
+
+namespace tools
+{
+namespace trace
+{
+namespace
+{
+struct Event
+{
+  const char * name;
+  uint64_t frame;
+  int64_t begin_ns;
+  int64_t end_ns;
+};
+
+// 单生产者（所属线程），save()读取时按写入计数丢弃可能正被覆盖的事件
+struct Buffer
+{
+  static constexpr std::size_t SIZE = 1 << 16;
+
+  std::array<Event, SIZE> events;
+  std::atomic<uint64_t> head = 0;
+  std::atomic<uint64_t> cleared = 0;  // clear()时的head，之前的事件不再导出
+  uint64_t frame = 0;
+  long tid;
+
+  std::mutex mutex;  // 仅保护name
+  std::string name;
+};
+
+std::mutex registry_mutex;
+std::vector<std::shared_ptr<Buffer>> registry;  // 线程退出后缓冲区仍保留，直到导出
+
+Buffer & buffer()
+{
+  thread_local std::shared_ptr<Buffer> local = [] {
+    auto buffer = std::make_shared<Buffer>();
+    buffer->tid = ::syscall(SYS_gettid);
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(buffer);
+    return buffer;
+  }();
+  return *local;
+}
+
+std::vector<Event> snapshot(const Buffer & buffer)
+{
+  auto end = buffer.head.load(std::memory_order_acquire);
+  auto begin = std::max(end > Buffer::SIZE ? end - Buffer::SIZE : 0, buffer.cleared.load());
+  if (begin >= end) return {};
+
+  std::vector<Event> events;
+  events.reserve(end - begin);
+  for (auto i = begin; i < end; i++) events.push_back(buffer.events[i % Buffer::SIZE]);
+
+  // 拷贝期间写入端可能已覆盖了最早的若干事件，正在写入的是下标为head的槽
+  std::atomic_thread_fence(std::memory_order_acquire);
+  auto head = buffer.head.load(std::memory_order_relaxed);
+  auto valid = head + 1 > Buffer::SIZE ? head + 1 - Buffer::SIZE : 0;
+  if (valid > begin) events.erase(events.begin(), events.begin() + std::min(valid, end) - begin);
+  return events;
+}
+
+}  // namespace
+
+Span::Span(const char * name) : name_(name), begin_ns_(now_ns()) {}
+
+Span::~Span() { record(name_, begin_ns_, now_ns()); }
+
+void record(const char * name, int64_t begin_ns, int64_t end_ns)
+{
+  auto & b = buffer();
+  auto head = b.head.load(std::memory_order_relaxed);
+  b.events[head % Buffer::SIZE] = {name, b.frame, begin_ns, end_ns};
+  b.head.store(head + 1, std::memory_order_release);
+}
+
+void set_frame(uint64_t frame) { buffer().frame = frame; }
+
+uint64_t frame() { return buffer().frame; }
+
+void set_thread_name(const std::string & name)
+{
+  auto & b = buffer();
+  std::lock_guard<std::mutex> lock(b.mutex);
+  b.name = name;
+}
+
+bool save(const std::string & path)
+{
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    buffers = registry;
+  }
+
+  std::ofstream file(path);
+  if (!file) {
+    tools::logger()->warn("Failed to open {}", path);
+    return false;
+  }
+
+  // ts、dur的单位为us；所有事件都在同一进程内
+  auto pid = ::getpid();
+  std::size_t count = 0;
+  auto first = true;
+  auto separator = [&] {
+    if (!first) file << ",\n";
+    first = false;
+  };
+
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  for (const auto & buffer : buffers) {
+    std::string name;
+    {
+      std::lock_guard<std::mutex> lock(buffer->mutex);
+      name = buffer->name;
+    }
+    if (!name.empty()) {
+      separator();
+      file << fmt::format(
+        "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},"
+        "\"args\":{{\"name\":\"{}\"}}}}",
+        pid, buffer->tid, name);
+    }
+
+    for (const auto & event : snapshot(*buffer)) {
+      separator();
+      file << fmt::format(
+        "{{\"name\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{},"
+        "\"args\":{{\"frame\":{}}}}}",
+        event.name, event.begin_ns / 1e3, (event.end_ns - event.begin_ns) / 1e3, pid, buffer->tid,
+        event.frame);
+      count++;
+    }
+  }
+  file << "\n]}\n";
+
+  tools::logger()->info("Saved {} trace events from {} threads to {}", count, buffers.size(), path);
+  return bool(file);
+}
+
+void clear()
+{
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  for (const auto & buffer : registry) buffer->cleared = buffer->head.load();
+
+  // 已退出的线程不会再写入，直接释放其缓冲区
+  auto exited = [](const auto & buffer) { return buffer.use_count() == 1; };
+  registry.erase(std::remove_if(registry.begin(), registry.end(), exited), registry.end());
+}
+
+}  // namespace trace
+
+}  // namespace tools
@@ -0,0 +1,91 @@
+#ifndef TOOLS__TRACER_HPP
+#define TOOLS__TRACER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace tools
+{
+// 逐帧流水线追踪，导出为Chrome trace-event JSON，可用chrome://tracing或ui.perfetto.dev打开
+// 每个线程写入自己的环形缓冲区，不加锁、不分配，满时覆盖最早的事件
+// 事件带有调用线程当前的帧号，由set_frame()设置，用于在不同线程间对应同一帧
+// 帧号取相机帧时间戳，随图像和TargetSnapshot传递，各线程无需各自计数
+// 定义TOOLS_DISABLE_TRACE后TOOLS_TRACE_*宏展开为空，不产生任何开销
+namespace trace
+{
+// 事件名只保存指针，必须是字符串字面量或生命周期足够长的字符串
+class Span
+{
+public:
+  explicit Span(const char * name);
+  ~Span();
+
+  Span(const Span &) = delete;
+  Span & operator=(const Span &) = delete;
+
+private:
+  const char * name_;
+  int64_t begin_ns_;
+};
+
+inline int64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+// 记录一个已结束的区间
+void record(const char * name, int64_t begin_ns, int64_t end_ns);
+
+// 设置调用线程之后的事件所属的帧号
+void set_frame(uint64_t frame);
+uint64_t frame();
+
+// 以相机帧时间戳(ns)作为帧号，未关联任何帧时传入零点，帧号为0
+inline void set_frame(std::chrono::steady_clock::time_point t)
+{
+  set_frame(std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+}
+
+// 导出时显示的线程名
+void set_thread_name(const std::string & name);
+
+// 可在运行中随时调用，导出各线程缓冲区中现有的事件
+bool save(const std::string & path);
+void clear();
+
+}  // namespace trace
+
+}  // namespace tools
+
+#define TOOLS_TRACE_CONCAT_(a, b) a##b
+#define TOOLS_TRACE_CONCAT(a, b) TOOLS_TRACE_CONCAT_(a, b)
+
+#ifndef TOOLS_DISABLE_TRACE
+// 追踪所在作用域，从此处到作用域结束
+#define TOOLS_TRACE_SPAN(name) \
+  tools::trace::Span TOOLS_TRACE_CONCAT(trace_span_, __LINE__)(name)
+// 追踪一个表达式，返回其结果，如auto armors = TOOLS_TRACE_CALL("yolo.detect", yolo.detect(img))
+#define TOOLS_TRACE_CALL(name, ...) \
+  [&]() -> decltype(auto) {         \
+    TOOLS_TRACE_SPAN(name);         \
+    return __VA_ARGS__;             \
+  }()
+#define TOOLS_TRACE_FRAME(frame) tools::trace::set_frame(frame)
+#define TOOLS_TRACE_THREAD(name) tools::trace::set_thread_name(name)
+#else
+#define TOOLS_TRACE_SPAN(name) \
+  do {                         \
+  } while (0)
+#define TOOLS_TRACE_CALL(name, ...) (__VA_ARGS__)
+#define TOOLS_TRACE_FRAME(frame) \
+  do {                           \
+  } while (0)
+#define TOOLS_TRACE_THREAD(name) \
+  do {                           \
+  } while (0)
+#endif
+
+#endif  // TOOLS__TRACER_HPP
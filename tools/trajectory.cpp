@@ -1,6 +1,9 @@
 #include "trajectory.hpp"
 
 #include <cmath>
+#include <limits>
+
+#include "simd_math.hpp"
 
 namespace tools
 {
@@ -30,4 +33,123 @@ Trajectory::Trajectory(const double v0, const double d, const double h)
   fly_time = (t_1 < t_2) ? t_1 : t_2;
 }
 
-}  // namespace tools
\ No newline at end of file
+// 与构造函数相同的二次方程，取|tan(pitch)|较小的根（飞行时间较短）
+// 该根写成2c / (d + sqrt(delta))的形式，避免a接近0时相消
+void Trajectory::solve_batch(
+  const double v0, const double * d, const double * h, double * pitch, double * fly_time, int n)
+{
+  constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+
+  for (int i = 0; i < n; i++) {
+    auto a = g * d[i] * d[i] / (2 * v0 * v0);
+    auto c = a + h[i];
+    auto delta = d[i] * d[i] - 4 * a * c;
+
+    auto tan_pitch = 2 * c / (d[i] + std::sqrt(delta > 0 ? delta : 0.0));
+    pitch[i] = delta < 0 ? nan : simd_atan2(tan_pitch, 1.0);
+    fly_time[i] = delta < 0 ? nan : d[i] * std::sqrt(1 + tan_pitch * tan_pitch) / v0;
+  }
+}
+
+namespace
+{
+constexpr double INTEGRATE_DT = 1e-3;  // s
+constexpr double MAX_FLY_TIME = 5.0;   // s
+constexpr double MIN_HEIGHT = -20.0;   // m
+
+struct State
+{
+  double x, y, vx, vy;
+
+  State operator+(const State & o) const { return {x + o.x, y + o.y, vx + o.vx, vy + o.vy}; }
+  State operator*(double s) const { return {x * s, y * s, vx * s, vy * s}; }
+};
+
+State derivative(const State & s, double k)
+{
+  auto v = std::hypot(s.vx, s.vy);
+  return {s.vx, s.vy, -k * v * s.vx, -g - k * v * s.vy};
+}
+
+State rk4_step(const State & s, double k, double dt)
+{
+  auto k1 = derivative(s, k);
+  auto k2 = derivative(s + k1 * (dt / 2), k);
+  auto k3 = derivative(s + k2 * (dt / 2), k);
+  auto k4 = derivative(s + k3 * dt, k);
+  return s + (k1 + k2 * 2 + k3 * 2 + k4) * (dt / 6);
+}
+
+}  // namespace
+
+void sample_trajectory(
+  const double k, const double v0, const double pitch, const double * d_list, int n,
+  double * h_list, double * t_list)
+{
+  State s{0, 0, v0 * std::cos(pitch), v0 * std::sin(pitch)};
+  auto t = 0.0;
+  int i = 0;
+  while (i < n && t < MAX_FLY_TIME && s.y > MIN_HEIGHT && s.vx > 0) {
+    auto next = rk4_step(s, k, INTEGRATE_DT);
+
+    // 步内按线性插值
+    for (; i < n && d_list[i] <= next.x; i++) {
+      auto ratio = (d_list[i] - s.x) / (next.x - s.x);
+      h_list[i] = s.y + ratio * (next.y - s.y);
+      t_list[i] = t + ratio * INTEGRATE_DT;
+    }
+
+    s = next;
+    t += INTEGRATE_DT;
+  }
+
+  for (; i < n; i++) {
+    h_list[i] = std::numeric_limits<double>::quiet_NaN();
+    t_list[i] = std::numeric_limits<double>::quiet_NaN();
+  }
+}
+
+// 低伸弹道上命中高度随出射角单调增加：先粗扫出第一个跨过h的区间，再二分
+// 出射角过低时弹丸在到达d之前已落到MIN_HEIGHT以下，跳过这些角度
+Trajectory Trajectory::integrate(const double k, const double v0, const double d, const double h)
+{
+  constexpr double MIN_PITCH = -80 / 57.3;
+  constexpr double MAX_PITCH = 60 / 57.3;
+  constexpr double SCAN_STEP = 1 / 57.3;
+
+  Trajectory result;
+  result.unsolvable = true;
+
+  auto shoot = [&](double pitch, double & y, double & t) {
+    sample_trajectory(k, v0, pitch, &d, 1, &y, &t);
+    return !std::isnan(y);
+  };
+
+  double lo = MIN_PITCH, hi = MIN_PITCH, y_lo = std::numeric_limits<double>::quiet_NaN(), y, t;
+  for (; hi <= MAX_PITCH; hi += SCAN_STEP) {
+    if (!shoot(hi, y, t)) {
+      if (std::isnan(y_lo)) continue;
+      return result;  // 出射角过高，vx衰减到0之前到不了d
+    }
+    if (y >= h) break;
+    if (!std::isnan(y_lo) && y <= y_lo) return result;  // 越过最高点仍未达到h
+    lo = hi;
+    y_lo = y;
+  }
+  if (hi > MAX_PITCH || std::isnan(y_lo)) return result;
+
+  for (int i = 0; i < 50 && hi - lo > 1e-9; i++) {
+    auto mid = (lo + hi) / 2;
+    if (shoot(mid, y, t) && y < h)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  shoot(hi, y, result.fly_time);
+  result.pitch = hi;
+  result.unsolvable = false;
+  return result;
+}
+
+}  // namespace tools
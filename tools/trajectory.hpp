@@ -9,13 +9,32 @@ struct Trajectory
   double fly_time;
   double pitch;  // 抬头为正
 
+  Trajectory() = default;
+
   // 不考虑空气阻力
   // v0 子弹初速度大小，单位：m/s
   // d 目标水平距离，单位：m
   // h 目标竖直高度，单位：m
   Trajectory(const double v0, const double d, const double h);
+
+  // 不考虑空气阻力，同一初速下批量求解，unsolvable时pitch和fly_time为NaN
+  // 使用simd_atan2且循环内无分支，可向量化，与逐个构造Trajectory的误差在1e-15量级
+  static void solve_batch(
+    const double v0, const double * d, const double * h, double * pitch, double * fly_time,
+    int n);
+
+  // 考虑空气阻力，加速度a = -g - k|v|v
+  // 以RK4积分弹道并二分出射角，耗时约为解析解的1e4倍，用于生成BallisticTable和验证其精度
+  // k 阻力系数，单位：1/m
+  static Trajectory integrate(const double k, const double v0, const double d, const double h);
 };
 
+// 考虑空气阻力时，以出射角pitch射出的弹丸飞过各水平距离时的高度和时间
+// d_list 须递增，到达不了的距离对应的h_list、t_list为NaN
+void sample_trajectory(
+  const double k, const double v0, const double pitch, const double * d_list, int n,
+  double * h_list, double * t_list);
+
 }  // namespace tools
 
-#endif  // TOOLS__TRAJECTORY_HPP
\ No newline at end of file
+#endif  // TOOLS__TRAJECTORY_HPP